@@ -1,5 +1,13 @@
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <BPlusTree.hpp>
 #include <Nodes.hpp>
+#include <benchmark.h>
 
 template<typename T>
 struct functor
@@ -32,12 +40,70 @@ std::ostream& operator << (std::ostream& os, const BinaryTree<T>& node)
     return os;
 }
 
-int main()
+// lookups, half of them for keys that are inside
+std::vector<int> make_probes(const std::vector<int>& keys, size_t count)
 {
+    std::mt19937 engine(7);
+    std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+    std::vector<int> probes = testing::make_input<int>(testing::distribution::random, count, 7);
+    for (size_t i = 0; i < count; i += 2)
+        probes[i] = keys[pick(engine)];
+    return probes;
+}
+
+template<typename Container>
+void benchmark_lookups(testing::benchmark_report& report, const testing::benchmark_arguments& arguments,
+    const std::string& container_name, const std::vector<int>& keys, const std::vector<int>& probes)
+{
+    const Container container(keys.begin(), keys.end());
+    size_t hits = 0;
+    const auto stats = testing::measure(
+        [&] { return &probes; },
+        [&](const std::vector<int>* input)
+        {
+            hits = 0;
+            for (int probe : *input)
+                hits += container.contains(probe);
+        },
+        arguments.options);
+    std::cout << container_name << ' ' << keys.size() << " keys, " << hits << " hits" << std::endl;
+    report.add({ "lookup", container_name, "int", testing::distribution::random, keys.size(), stats });
+}
+
+void benchmark_ordered_sets(testing::benchmark_report& report, const testing::benchmark_arguments& arguments)
+{
+    for (size_t length = 1000; length <= 1000000 && length <= arguments.max_length; length *= 10)
+    {
+        const auto keys = testing::make_input<int>(testing::distribution::random, length);
+        const auto probes = make_probes(keys, 1000000);
+        benchmark_lookups<BPlusSet<int>>(report, arguments, "BPlusSet", keys, probes);
+        benchmark_lookups<BinaryTree<int>>(report, arguments, "BinaryTree", keys, probes);
+        benchmark_lookups<BinaryTree<int, std::less<int>, balancing::red_black>>(report, arguments, "BinaryTree red_black", keys, probes);
+        benchmark_lookups<std::set<int>>(report, arguments, "std::set", keys, probes);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    testing::benchmark_arguments arguments;
+    try
+    {
+        arguments = testing::benchmark_arguments::parse(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl
+            << "usage: Labor3cli [--output-dir DIR] [--format csv|json] [--warmup N] [--trials N] [--fence X] [--max-length N]" << std::endl;
+        return 1;
+    }
+
     BinaryTree<int> t = {1, 5, 89, 42, 9, 10, 55, 22, 34};
     t.set_pattern({1, 0, -1});
 
-    std::cout << t;
-    
+    std::cout << t << std::endl;
 
+    testing::benchmark_report report;
+    benchmark_ordered_sets(report, arguments);
+    std::ofstream file(arguments.path("ordered_lookup"));
+    report.write(file, arguments.format);
 }
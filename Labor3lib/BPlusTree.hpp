@@ -0,0 +1,795 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bplus
+{
+    inline constexpr size_t cache_line = 64;
+
+    // the Value of a set, nothing is stored for it
+    struct no_value {};
+
+    // forward iterators that may return proxies, like the ones of a map
+    template <typename Iterator>
+    concept multipass_iterator = std::input_or_output_iterator<Iterator>
+        && std::derived_from<typename std::iterator_traits<Iterator>::iterator_category, std::forward_iterator_tag>;
+
+    template <typename Key, typename Compare>
+    inline constexpr bool is_scannable = std::is_arithmetic_v<Key>
+        && (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+    // Number of keys less than key, or not greater than it for upper.
+    // Numbers are searched by halves without branches, the next half is picked
+    // with a conditional move, so a lookup does not stall on mispredictions.
+    template <bool upper, typename Key, size_t Capacity, typename Compare>
+    size_t search(const std::array<Key, Capacity>& keys, size_t count, const Key& key, const Compare& cmp)
+    {
+        if constexpr (is_scannable<Key, Compare>)
+        {
+            if (count == 0)
+                return 0;
+            const Key* base = keys.data();
+            // the answer is always in [base, base + count]
+            while (count > 1)
+            {
+                const size_t half = count / 2;
+                if constexpr (upper)
+                    base += !(key < base[half]) * half;
+                else
+                    base += (base[half] < key) * half;
+                count -= half;
+            }
+            if constexpr (upper)
+                return base - keys.data() + !(key < *base);
+            else
+                return base - keys.data() + (*base < key);
+        }
+        else if constexpr (upper)
+            return std::upper_bound(keys.begin(), keys.begin() + count, key, cmp) - keys.begin();
+        else
+            return std::lower_bound(keys.begin(), keys.begin() + count, key, cmp) - keys.begin();
+    }
+}
+
+
+// Ordered set or map with every node a few cache lines wide. The keys of a node are
+// stored next to each other, the values live in the leaves only and the leaves are
+// linked both ways, so iterating reads the keys in order without climbing the tree.
+// An inner node with n keys has n + 1 children, all keys of children[i] are less
+// than keys[i] and the keys of children[i + 1] are not.
+template<
+std::semiregular Key,
+typename Value = bplus::no_value,
+std::relation<Key, Key> Compare = std::less<Key>,
+size_t NodeLines = 4>
+class BPlusTree
+{
+    static constexpr bool is_map = !std::is_same_v<Value, bplus::no_value>;
+
+    struct node
+    {
+        bool leaf;
+        size_t count = 0;
+    };
+
+    struct leaf;
+
+    // an inner node has one child more than keys, a leaf links to both neighbours
+    // and a set leaf keeps a single placeholder value
+    static constexpr size_t inner_header = sizeof(node) + sizeof(node*);
+    static constexpr size_t inner_entry = sizeof(Key) + sizeof(node*);
+    static constexpr size_t leaf_header = sizeof(node) + 2 * sizeof(leaf*) + (is_map ? 0 : sizeof(Value));
+    static constexpr size_t leaf_entry = sizeof(Key) + (is_map ? sizeof(Value) : 0);
+
+    // big keys or values widen the nodes past NodeLines, so that four of them still fit
+    static constexpr size_t node_bytes = std::max(NodeLines * bplus::cache_line,
+        (std::max(inner_header + 4 * inner_entry, leaf_header + 4 * leaf_entry) + bplus::cache_line - 1)
+        / bplus::cache_line * bplus::cache_line);
+
+public:
+    static constexpr size_t inner_capacity = (node_bytes - inner_header) / inner_entry;
+    static constexpr size_t leaf_capacity = (node_bytes - leaf_header) / leaf_entry;
+
+private:
+    // nodes hold at least half of their capacity, apart from the root
+    static constexpr size_t inner_minimum = inner_capacity / 2;
+    static constexpr size_t leaf_minimum = leaf_capacity / 2;
+    // fan-out of two at least, 64 levels outnumber any size_t
+    static constexpr size_t max_height = 64;
+
+    struct alignas(bplus::cache_line) inner : node
+    {
+        std::array<Key, inner_capacity> keys{};
+        std::array<node*, inner_capacity + 1> children{};
+
+        inner() : node{ false } {}
+    };
+
+    struct alignas(bplus::cache_line) leaf : node
+    {
+        // the links go first, the keys and values of a map are padded only once
+        leaf* previous = nullptr;
+        leaf* next = nullptr;
+        std::array<Key, leaf_capacity> keys{};
+        std::array<Value, is_map ? leaf_capacity : 1> values{};
+
+        leaf() : node{ true } {}
+    };
+
+    static_assert(sizeof(leaf) <= node_bytes && sizeof(inner) <= node_bytes);
+
+    node* _root = nullptr;
+    leaf* _first = nullptr;
+    leaf* _last = nullptr;
+    size_t _size = 0;
+    Compare _cmp{};
+
+public:
+    template<bool Const>
+    class basic_iterator
+    {
+        friend class BPlusTree;
+        template<bool> friend class basic_iterator;
+
+        using tree_type = std::conditional_t<Const, const BPlusTree, BPlusTree>;
+
+        tree_type* _tree = nullptr;
+        leaf* _leaf = nullptr;
+        size_t _index = 0;
+
+        basic_iterator(tree_type* tree, leaf* at, size_t index)
+            : _tree(tree), _leaf(at), _index(index)
+        {
+            // the position after the last key of a leaf is the first of the next one
+            if (_leaf != nullptr && _index == _leaf->count)
+            {
+                _leaf = _leaf->next;
+                _index = 0;
+            }
+        }
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::conditional_t<is_map, std::pair<Key, Value>, Key>;
+        using reference = std::conditional_t<is_map,
+            std::pair<const Key&, std::conditional_t<Const, const Value&, Value&>>, const Key&>;
+
+        basic_iterator() = default;
+
+        operator basic_iterator<true>() const
+        {
+            return { _tree, _leaf, _index };
+        }
+
+        const Key& key() const
+        {
+            return _leaf->keys[_index];
+        }
+
+        std::conditional_t<Const, const Value&, Value&> value() const requires is_map
+        {
+            return _leaf->values[_index];
+        }
+
+        reference operator*() const
+        {
+            if constexpr (is_map)
+                return { key(), value() };
+            else
+                return key();
+        }
+
+        const Key* operator->() const requires (!is_map)
+        {
+            return &key();
+        }
+
+        basic_iterator& operator++()
+        {
+            if (++_index == _leaf->count)
+            {
+                _leaf = _leaf->next;
+                _index = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        // from the end goes to the last key
+        basic_iterator& operator--()
+        {
+            if (_leaf == nullptr)
+            {
+                _leaf = _tree->_last;
+                _index = _leaf->count;
+            }
+            else if (_index == 0)
+            {
+                _leaf = _leaf->previous;
+                _index = _leaf->count;
+            }
+            --_index;
+            return *this;
+        }
+
+        basic_iterator operator--(int)
+        {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        bool operator==(const basic_iterator& other) const
+        {
+            return _leaf == other._leaf && _index == other._index;
+        }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    BPlusTree() = default;
+
+    BPlusTree(const BPlusTree& other)
+        : _cmp(other._cmp)
+    {
+        bulk_load(other.begin(), other.end());
+    }
+
+    BPlusTree(BPlusTree&& other) noexcept
+        : _root(std::exchange(other._root, nullptr)),
+        _first(std::exchange(other._first, nullptr)),
+        _last(std::exchange(other._last, nullptr)),
+        _size(std::exchange(other._size, 0)),
+        _cmp(std::move(other._cmp))
+    {}
+
+    template<std::input_iterator IteratorType>
+    BPlusTree(IteratorType begin_it, IteratorType end_it)
+    {
+        for (; begin_it != end_it; ++begin_it)
+        {
+            if constexpr (is_map)
+                insert((*begin_it).first, (*begin_it).second);
+            else
+                insert(*begin_it);
+        }
+    }
+
+    BPlusTree(std::initializer_list<std::conditional_t<is_map, std::pair<Key, Value>, Key>> list)
+        : BPlusTree(list.begin(), list.end())
+    {}
+
+    BPlusTree& operator=(BPlusTree other) noexcept
+    {
+        std::swap(_root, other._root);
+        std::swap(_first, other._first);
+        std::swap(_last, other._last);
+        std::swap(_size, other._size);
+        std::swap(_cmp, other._cmp);
+        return *this;
+    }
+
+    ~BPlusTree() noexcept
+    {
+        clear();
+    }
+
+    size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    // levels from the root to the leaves
+    size_t height() const noexcept
+    {
+        size_t levels = 0;
+        for (const node* at = _root; at != nullptr; levels += 1)
+            at = at->leaf ? nullptr : static_cast<const inner*>(at)->children[0];
+        return levels;
+    }
+
+    void clear() noexcept
+    {
+        destroy(_root);
+        _root = nullptr;
+        _first = _last = nullptr;
+        _size = 0;
+    }
+
+    bool insert(const Key& key) requires (!is_map)
+    {
+        return emplace(key);
+    }
+
+    bool insert(const Key& key, Value value) requires is_map
+    {
+        return emplace(key, std::move(value));
+    }
+
+    Value& operator[](const Key& key) requires is_map
+    {
+        emplace(key);
+        return find(key).value();
+    }
+
+    Value& at(const Key& key) requires is_map
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("in BPlusTree::at the key is missing");
+        return it.value();
+    }
+
+    const Value& at(const Key& key) const requires is_map
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("in BPlusTree::at the key is missing");
+        return it.value();
+    }
+
+    bool contains(const Key& key) const
+    {
+        // the leaf of key holds it if anyone does, no iterator is needed
+        const leaf* at = find_leaf(key);
+        if (at == nullptr)
+            return false;
+        const size_t index = bplus::search<false>(at->keys, at->count, key, _cmp);
+        return index < at->count && !_cmp(key, at->keys[index]);
+    }
+
+    iterator find(const Key& key)
+    {
+        auto it = lower_bound(key);
+        return it != end() && !_cmp(key, it.key()) ? it : end();
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        auto it = lower_bound(key);
+        return it != end() && !_cmp(key, it.key()) ? it : end();
+    }
+
+    // the first key not less than key
+    iterator lower_bound(const Key& key)
+    {
+        auto* at = find_leaf(key);
+        return { this, at, at == nullptr ? 0 : bplus::search<false>(at->keys, at->count, key, _cmp) };
+    }
+
+    const_iterator lower_bound(const Key& key) const
+    {
+        auto* at = find_leaf(key);
+        return { this, at, at == nullptr ? 0 : bplus::search<false>(at->keys, at->count, key, _cmp) };
+    }
+
+    // the first key greater than key
+    iterator upper_bound(const Key& key)
+    {
+        auto* at = find_leaf(key);
+        return { this, at, at == nullptr ? 0 : bplus::search<true>(at->keys, at->count, key, _cmp) };
+    }
+
+    const_iterator upper_bound(const Key& key) const
+    {
+        auto* at = find_leaf(key);
+        return { this, at, at == nullptr ? 0 : bplus::search<true>(at->keys, at->count, key, _cmp) };
+    }
+
+    bool erase(const Key& key)
+    {
+        if (_root == nullptr)
+            return false;
+
+        std::array<std::pair<inner*, size_t>, max_height> path;
+        size_t depth = 0;
+        auto* at = descend(key, path, depth);
+        const size_t index = bplus::search<false>(at->keys, at->count, key, _cmp);
+        if (index == at->count || _cmp(key, at->keys[index]))
+            return false;
+
+        erase_at(at, index);
+        _size -= 1;
+        if (at == _root)
+        {
+            if (at->count == 0)
+                clear();
+            return true;
+        }
+        if (at->count < leaf_minimum)
+            fix_leaf(at, path, depth);
+        return true;
+    }
+
+    // Replaces the contents by the strictly increasing range in O(n), the leaves are
+    // filled evenly and every level above is built from the one below.
+    template<bplus::multipass_iterator IteratorType>
+    void bulk_load(IteratorType begin_it, IteratorType end_it)
+    {
+        auto key_of = [](const auto& item) -> const Key&
+        {
+            if constexpr (is_map)
+                return item.first;
+            else
+                return item;
+        };
+        if (std::adjacent_find(begin_it, end_it, [&](const auto& lhs, const auto& rhs)
+            { return !_cmp(key_of(lhs), key_of(rhs)); }) != end_it)
+            throw std::invalid_argument("in BPlusTree::bulk_load the range is not strictly increasing");
+
+        clear();
+        const auto count = static_cast<size_t>(std::distance(begin_it, end_it));
+        if (count == 0)
+            return;
+
+        // children of the next level with their smallest keys
+        std::vector<std::pair<node*, Key>> level;
+        const size_t leaves = (count + leaf_capacity - 1) / leaf_capacity;
+        level.reserve(leaves);
+        for (size_t i = 0; i < leaves; ++i)
+        {
+            auto* at = new leaf;
+            at->count = count / leaves + (i < count % leaves);
+            for (size_t j = 0; j < at->count; ++j, ++begin_it)
+            {
+                const auto& item = *begin_it;
+                at->keys[j] = key_of(item);
+                if constexpr (is_map)
+                    at->values[j] = item.second;
+            }
+            at->previous = _last;
+            (_last != nullptr ? _last->next : _first) = at;
+            _last = at;
+            level.emplace_back(at, at->keys[0]);
+        }
+
+        while (level.size() > 1)
+        {
+            std::vector<std::pair<node*, Key>> parents;
+            const size_t groups = (level.size() + inner_capacity) / (inner_capacity + 1);
+            parents.reserve(groups);
+            for (size_t i = 0, child = 0; i < groups; ++i)
+            {
+                auto* at = new inner;
+                const size_t children = level.size() / groups + (i < level.size() % groups);
+                at->count = children - 1;
+                for (size_t j = 0; j < children; ++j, ++child)
+                {
+                    at->children[j] = level[child].first;
+                    if (j > 0)
+                        at->keys[j - 1] = level[child].second;
+                }
+                parents.emplace_back(at, level[child - children].second);
+            }
+            level = std::move(parents);
+        }
+        _root = level.front().first;
+        _size = count;
+    }
+
+    iterator begin() noexcept
+    {
+        return { this, _first, 0 };
+    }
+    iterator end() noexcept
+    {
+        return { this, nullptr, 0 };
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return { this, _first, 0 };
+    }
+    const_iterator end() const noexcept
+    {
+        return { this, nullptr, 0 };
+    }
+
+private:
+    static void destroy(node* at) noexcept
+    {
+        if (at == nullptr)
+            return;
+        if (at->leaf)
+        {
+            delete static_cast<leaf*>(at);
+            return;
+        }
+        auto* parent = static_cast<inner*>(at);
+        for (size_t i = 0; i <= parent->count; ++i)
+            destroy(parent->children[i]);
+        delete parent;
+    }
+
+    leaf* find_leaf(const Key& key) const
+    {
+        node* at = _root;
+        while (at != nullptr && !at->leaf)
+        {
+            auto* parent = static_cast<inner*>(at);
+            at = parent->children[bplus::search<true>(parent->keys, parent->count, key, _cmp)];
+        }
+        return static_cast<leaf*>(at);
+    }
+
+    // the leaf of key, path gets every inner node on the way with the child taken
+    leaf* descend(const Key& key, std::array<std::pair<inner*, size_t>, max_height>& path, size_t& depth) const
+    {
+        node* at = _root;
+        while (!at->leaf)
+        {
+            auto* parent = static_cast<inner*>(at);
+            const size_t index = bplus::search<true>(parent->keys, parent->count, key, _cmp);
+            path[depth++] = { parent, index };
+            at = parent->children[index];
+        }
+        return static_cast<leaf*>(at);
+    }
+
+    template<typename... Arguments>
+    bool emplace(const Key& key, Arguments&&... value)
+    {
+        if (_root == nullptr)
+            _root = _first = _last = new leaf;
+
+        std::array<std::pair<inner*, size_t>, max_height> path;
+        size_t depth = 0;
+        auto* at = descend(key, path, depth);
+        size_t index = bplus::search<false>(at->keys, at->count, key, _cmp);
+        if (index < at->count && !_cmp(key, at->keys[index]))
+            return false;
+
+        node* right = nullptr;
+        if (at->count == leaf_capacity)
+        {
+            auto* half = split_leaf(at);
+            right = half;
+            if (index > at->count)
+            {
+                index -= at->count;
+                at = half;
+            }
+        }
+        insert_at(at, index, key, std::forward<Arguments>(value)...);
+        _size += 1;
+
+        if (right != nullptr)
+            insert_child(static_cast<leaf*>(right)->keys[0], right, path, depth);
+        return true;
+    }
+
+    template<typename... Arguments>
+    static void insert_at(leaf* at, size_t index, const Key& key, Arguments&&... value)
+    {
+        std::move_backward(at->keys.begin() + index, at->keys.begin() + at->count, at->keys.begin() + at->count + 1);
+        at->keys[index] = key;
+        if constexpr (is_map)
+        {
+            std::move_backward(at->values.begin() + index, at->values.begin() + at->count, at->values.begin() + at->count + 1);
+            at->values[index] = Value(std::forward<Arguments>(value)...);
+        }
+        at->count += 1;
+    }
+
+    static void erase_at(leaf* at, size_t index)
+    {
+        std::move(at->keys.begin() + index + 1, at->keys.begin() + at->count, at->keys.begin() + index);
+        if constexpr (is_map)
+            std::move(at->values.begin() + index + 1, at->values.begin() + at->count, at->values.begin() + index);
+        at->count -= 1;
+    }
+
+    // the upper half of a full leaf moves to a new leaf after it
+    leaf* split_leaf(leaf* at)
+    {
+        auto* right = new leaf;
+        const size_t half = leaf_capacity / 2;
+        right->count = leaf_capacity - half;
+        std::move(at->keys.begin() + half, at->keys.end(), right->keys.begin());
+        if constexpr (is_map)
+            std::move(at->values.begin() + half, at->values.end(), right->values.begin());
+        at->count = half;
+
+        right->previous = at;
+        right->next = at->next;
+        (at->next != nullptr ? at->next->previous : _last) = right;
+        at->next = right;
+        return right;
+    }
+
+    // Puts separator and right after the child taken at path[depth - 1], a full parent
+    // is split around its middle key, which goes up the same way.
+    void insert_child(Key separator, node* right, std::array<std::pair<inner*, size_t>, max_height>& path, size_t depth)
+    {
+        while (right != nullptr)
+        {
+            if (depth == 0)
+            {
+                auto* root = new inner;
+                root->count = 1;
+                root->keys[0] = std::move(separator);
+                root->children[0] = _root;
+                root->children[1] = right;
+                _root = root;
+                return;
+            }
+
+            auto [parent, index] = path[--depth];
+            if (parent->count < inner_capacity)
+            {
+                std::move_backward(parent->keys.begin() + index, parent->keys.begin() + parent->count, parent->keys.begin() + parent->count + 1);
+                std::move_backward(parent->children.begin() + index + 1, parent->children.begin() + parent->count + 1, parent->children.begin() + parent->count + 2);
+                parent->keys[index] = std::move(separator);
+                parent->children[index + 1] = right;
+                parent->count += 1;
+                return;
+            }
+
+            std::array<Key, inner_capacity + 1> keys;
+            std::array<node*, inner_capacity + 2> children;
+            std::move(parent->keys.begin(), parent->keys.begin() + index, keys.begin());
+            keys[index] = std::move(separator);
+            std::move(parent->keys.begin() + index, parent->keys.end(), keys.begin() + index + 1);
+            std::copy(parent->children.begin(), parent->children.begin() + index + 1, children.begin());
+            children[index + 1] = right;
+            std::copy(parent->children.begin() + index + 1, parent->children.end(), children.begin() + index + 2);
+
+            const size_t middle = (inner_capacity + 1) / 2;
+            auto* half = new inner;
+            parent->count = middle;
+            half->count = inner_capacity - middle;
+            std::move(keys.begin(), keys.begin() + middle, parent->keys.begin());
+            std::copy(children.begin(), children.begin() + middle + 1, parent->children.begin());
+            std::move(keys.begin() + middle + 1, keys.end(), half->keys.begin());
+            std::copy(children.begin() + middle + 1, children.end(), half->children.begin());
+
+            separator = std::move(keys[middle]);
+            right = half;
+        }
+    }
+
+    // removes keys[index] and children[index + 1] of parent, merged into the child before
+    static void erase_child(inner* parent, size_t index)
+    {
+        std::move(parent->keys.begin() + index + 1, parent->keys.begin() + parent->count, parent->keys.begin() + index);
+        std::move(parent->children.begin() + index + 2, parent->children.begin() + parent->count + 1, parent->children.begin() + index + 1);
+        parent->count -= 1;
+    }
+
+    // A leaf below the minimum takes a key from a sibling that has one to spare,
+    // otherwise it is merged with a sibling and the parent loses a key.
+    void fix_leaf(leaf* at, std::array<std::pair<inner*, size_t>, max_height>& path, size_t depth)
+    {
+        auto [parent, index] = path[depth - 1];
+        auto* left = index > 0 ? static_cast<leaf*>(parent->children[index - 1]) : nullptr;
+        auto* right = index < parent->count ? static_cast<leaf*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > leaf_minimum)
+        {
+            if constexpr (is_map)
+                insert_at(at, 0, left->keys[left->count - 1], std::move(left->values[left->count - 1]));
+            else
+                insert_at(at, 0, left->keys[left->count - 1]);
+            left->count -= 1;
+            parent->keys[index - 1] = at->keys[0];
+            return;
+        }
+        if (right != nullptr && right->count > leaf_minimum)
+        {
+            if constexpr (is_map)
+                insert_at(at, at->count, right->keys[0], std::move(right->values[0]));
+            else
+                insert_at(at, at->count, right->keys[0]);
+            erase_at(right, 0);
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+
+        if (left == nullptr)
+        {
+            left = at;
+            index += 1;
+        }
+        else
+            right = at;
+        std::move(right->keys.begin(), right->keys.begin() + right->count, left->keys.begin() + left->count);
+        if constexpr (is_map)
+            std::move(right->values.begin(), right->values.begin() + right->count, left->values.begin() + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        (right->next != nullptr ? right->next->previous : _last) = left;
+        delete right;
+
+        erase_child(parent, index - 1);
+        fix_inner(path, depth);
+    }
+
+    // the same for the inner node at path[depth - 1], keys rotate through the parent
+    void fix_inner(std::array<std::pair<inner*, size_t>, max_height>& path, size_t depth)
+    {
+        auto* at = path[depth - 1].first;
+        if (depth == 1)
+        {
+            if (at->count == 0)
+            {
+                _root = at->children[0];
+                delete at;
+            }
+            return;
+        }
+        if (at->count >= inner_minimum)
+            return;
+
+        auto [parent, index] = path[depth - 2];
+        auto* left = index > 0 ? static_cast<inner*>(parent->children[index - 1]) : nullptr;
+        auto* right = index < parent->count ? static_cast<inner*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > inner_minimum)
+        {
+            std::move_backward(at->keys.begin(), at->keys.begin() + at->count, at->keys.begin() + at->count + 1);
+            std::move_backward(at->children.begin(), at->children.begin() + at->count + 1, at->children.begin() + at->count + 2);
+            at->keys[0] = std::move(parent->keys[index - 1]);
+            at->children[0] = left->children[left->count];
+            parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+            left->count -= 1;
+            at->count += 1;
+            return;
+        }
+        if (right != nullptr && right->count > inner_minimum)
+        {
+            at->keys[at->count] = std::move(parent->keys[index]);
+            at->children[at->count + 1] = right->children[0];
+            parent->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys.begin() + 1, right->keys.begin() + right->count, right->keys.begin());
+            std::move(right->children.begin() + 1, right->children.begin() + right->count + 1, right->children.begin());
+            right->count -= 1;
+            at->count += 1;
+            return;
+        }
+
+        if (left == nullptr)
+        {
+            left = at;
+            index += 1;
+        }
+        else
+            right = at;
+        left->keys[left->count] = std::move(parent->keys[index - 1]);
+        std::move(right->keys.begin(), right->keys.begin() + right->count, left->keys.begin() + left->count + 1);
+        std::copy(right->children.begin(), right->children.begin() + right->count + 1, left->children.begin() + left->count + 1);
+        left->count += right->count + 1;
+        delete right;
+
+        erase_child(parent, index - 1);
+        fix_inner(path, depth - 1);
+    }
+};
+
+template<typename Key, typename Compare = std::less<Key>>
+using BPlusSet = BPlusTree<Key, bplus::no_value, Compare>;
+
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+using BPlusMap = BPlusTree<Key, Value, Compare>;
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <concepts>
 #include <functional>
-#include <stack>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 template <typename T, size_t N>
 struct Node
@@ -13,6 +19,10 @@ struct Node
     Node* parent = nullptr;
     std::array<Node*, N> children = {nullptr};
     int my_index = -1;
+    // kept by the balancing policy of the tree, the height for avl, the color for red_black
+    int balance = 0;
+    // nodes in the subtree of this one, itself included
+    size_t subtree_size = 1;
 
     void link(size_t index, Node* child)
     {
@@ -28,6 +38,9 @@ struct Node
 };
 
 
+// Walks the tree by the parent pointers, without any state besides the current node.
+// pattern lists the children in the order they are visited, -1 is the node itself:
+// {0, -1, 1} in-order, {-1, 0, 1} pre-order, {0, 1, -1} post-order, {1, -1, 0} reversed.
 template <typename T, size_t N>
 struct NodeIterator
 {
@@ -43,46 +56,86 @@ struct NodeIterator
     node* current = nullptr;
     
     std::array<int, N + 1> pattern{};
-    std::stack<int> state{};
-    
-    void next()
+    // where every child stands in pattern, the node itself at N
+    std::array<size_t, N + 1> place{};
+
+    // the first node at or after pattern[from] of at, going up when at is done
+    node* forward(node* at, size_t from) const
     {
-        if (state.empty()) 
-            return;
-        if (state.top() == (N + 1))
+        while (at != nullptr)
         {
-            current = current->parent;
-            state.pop();
-            return next();
+            if (from > N)
+            {
+                from = at->parent != nullptr ? place[at->my_index] + 1 : 0;
+                at = at->parent;
+                continue;
+            }
+            if (pattern[from] == -1)
+                return at;
+            if (auto* child = at->children[pattern[from]])
+            {
+                at = child;
+                from = 0;
+            }
+            else
+                from += 1;
         }
-        if (pattern.at(state.top()) == -1)
-        {
-            state.top() += 1;
-            return;
-        }
-        auto* child = current->children.at(pattern.at(state.top())); 
-        if (child == nullptr)
+        return nullptr;
+    }
+
+    // the same as forward, reading the pattern from the back
+    node* backward(node* at, std::ptrdiff_t from) const
+    {
+        while (at != nullptr)
         {
-            state.top() += 1;
-            return next();
+            if (from < 0)
+            {
+                from = at->parent != nullptr ? static_cast<std::ptrdiff_t>(place[at->my_index]) - 1 : 0;
+                at = at->parent;
+                continue;
+            }
+            if (pattern[from] == -1)
+                return at;
+            if (auto* child = at->children[pattern[from]])
+            {
+                at = child;
+                from = N;
+            }
+            else
+                from -= 1;
         }
-        state.top() += 1;
+        return nullptr;
+    }
 
-        current = child;
-        state.push(0);
+    void next()
+    {
+        if (current != nullptr)
+            current = forward(current, place[N] + 1);
+    }
 
-        return next();
+    // from the end goes to the last node
+    void previous()
+    {
+        if (current == nullptr)
+            current = backward(root, N);
+        else
+            current = backward(current, static_cast<std::ptrdiff_t>(place[N]) - 1);
     }
 
 
+    NodeIterator() = default;
+
+    NodeIterator(node* root, node* current, std::array<int, N + 1> pattern)
+        : root(root), current(current), pattern(pattern)
+    {
+        for (size_t i = 0; i <= N; ++i)
+            place[pattern[i] == -1 ? N : pattern[i]] = i;
+    }
+
     NodeIterator(node* root, std::array<int, N + 1> pattern)
-        : root(root), current(root), pattern(pattern)
+        : NodeIterator(root, nullptr, pattern)
     {
-        if (root != nullptr)
-        {
-            state.push(0);
-            next();
-        }
+        current = forward(root, 0);
     }
 
     NodeIterator& operator++()
@@ -91,25 +144,45 @@ struct NodeIterator
         return *this;
     }
 
-    reference operator*()
+    NodeIterator operator++(int)
+    {
+        auto copy = *this;
+        next();
+        return copy;
+    }
+
+    NodeIterator& operator--()
+    {
+        previous();
+        return *this;
+    }
+
+    NodeIterator operator--(int)
+    {
+        auto copy = *this;
+        previous();
+        return copy;
+    }
+
+    reference operator*() const
     {
         return current->data;
     }
 
-    pointer operator->()
+    pointer operator->() const
     {
         return &current->data;
     }
 
     bool operator==(const NodeIterator& other) const
     {
-        return static_cast<bool>(other) == static_cast<bool>(*this);
+        return current == other.current;
     }
 
 
     operator bool() const
     {
-        return !state.empty();
+        return current != nullptr;
     }
 };
 
@@ -139,9 +212,279 @@ node_search(Node<T, N>* tree, const T& value)
 }
 
 
+// Policies of BinaryTree, both keep the height logarithmic.
+// inserted(root, node) is called after node is linked as a leaf,
+// removed(root, parent, index, balance) after a node with at most one child
+// was replaced by that child at parent->children[index], parent is null for the root,
+// built(node, depth, height) for every node of a perfectly balanced tree of that height
+// built from the bottom up. join(left, node, right), if present, makes one tree out of
+// detached trees with every value of left less than node and node less than right.
+namespace balancing
+{
+    namespace detail
+    {
+        // child takes the place of node under its parent, child may be null
+        template <typename NodeType>
+        void replace(NodeType*& root, NodeType* node, NodeType* child)
+        {
+            auto* parent = node->parent;
+            if (parent == nullptr)
+            {
+                root = child;
+                if (child != nullptr)
+                {
+                    child->parent = nullptr;
+                    child->my_index = -1;
+                }
+            }
+            else if (child != nullptr)
+                parent->link(node->my_index, child);
+            else
+                parent->children[node->my_index] = nullptr;
+        }
+
+        template <typename NodeType>
+        size_t subtree_size(const NodeType* node)
+        {
+            return node == nullptr ? 0 : node->subtree_size;
+        }
+
+        template <typename NodeType>
+        void update_size(NodeType* node)
+        {
+            node->subtree_size = 1 + subtree_size(node->children[0]) + subtree_size(node->children[1]);
+        }
+
+        // node goes down to children[index], its other child takes its place
+        template <typename NodeType>
+        NodeType* rotate(NodeType*& root, NodeType* node, size_t index)
+        {
+            auto* child = node->children[!index];
+            auto* inner = child->children[index];
+            replace(root, node, child);
+            node->children[!index] = nullptr;
+            if (inner != nullptr)
+                node->link(!index, inner);
+            child->link(index, node);
+            update_size(node);
+            update_size(child);
+            return child;
+        }
+
+        // one node more or less below node, for every ancestor up to the root
+        template <typename NodeType>
+        void resize_path(NodeType* node, bool grow)
+        {
+            for (; node != nullptr; node = node->parent)
+                node->subtree_size = grow ? node->subtree_size + 1 : node->subtree_size - 1;
+        }
+    }
+
+    // Heights of the children differ by at most one, the height is below 1.45 log2(n + 2).
+    struct avl
+    {
+        template <typename NodeType>
+        static int height(const NodeType* node)
+        {
+            return node == nullptr ? 0 : node->balance;
+        }
+
+        template <typename NodeType>
+        static void update(NodeType* node)
+        {
+            node->balance = 1 + std::max(height(node->children[0]), height(node->children[1]));
+        }
+
+        // fixes heights from node to the root, rotating where they differ by two
+        template <typename NodeType>
+        static void rebalance(NodeType*& root, NodeType* node)
+        {
+            for (; node != nullptr; node = node->parent)
+            {
+                update(node);
+                const int difference = height(node->children[0]) - height(node->children[1]);
+                if (difference < 2 && difference > -2)
+                    continue;
+
+                const size_t heavy = difference < 0;
+                auto* child = node->children[heavy];
+                if (height(child->children[!heavy]) > height(child->children[heavy]))
+                    update(detail::rotate(root, child, heavy)->children[heavy]);
+                node = detail::rotate(root, node, !heavy);
+                update(node->children[!heavy]);
+                update(node->children[heavy]);
+                update(node);
+            }
+        }
+
+        template <typename NodeType>
+        static void inserted(NodeType*& root, NodeType* node)
+        {
+            node->balance = 1;
+            rebalance(root, node->parent);
+        }
+
+        template <typename NodeType>
+        static void removed(NodeType*& root, NodeType* parent, size_t, int)
+        {
+            rebalance(root, parent);
+        }
+
+        template <typename NodeType>
+        static void built(NodeType* node, size_t, size_t)
+        {
+            update(node);
+        }
+
+        // O(1 + the difference of the heights), node goes down the spine of the taller tree
+        // to the first subtree at most one higher than the other tree
+        template <typename NodeType>
+        static NodeType* join(NodeType* left, NodeType* node, NodeType* right)
+        {
+            node->children = {};
+            const int difference = height(left) - height(right);
+            if (difference < 2 && difference > -2)
+            {
+                node->parent = nullptr;
+                node->my_index = -1;
+                if (left != nullptr)
+                    node->link(0, left);
+                if (right != nullptr)
+                    node->link(1, right);
+                update(node);
+                detail::update_size(node);
+                return node;
+            }
+
+            const size_t heavy = difference < 0;
+            auto* root = heavy ? right : left;
+            auto* other = heavy ? left : right;
+            auto* parent = root;
+            auto* at = root->children[!heavy];
+            while (height(at) > height(other) + 1)
+            {
+                parent = at;
+                at = at->children[!heavy];
+            }
+
+            if (at != nullptr)
+                node->link(heavy, at);
+            if (other != nullptr)
+                node->link(!heavy, other);
+            update(node);
+            detail::update_size(node);
+            parent->link(!heavy, node);
+            for (auto* up = parent; up != nullptr; up = up->parent)
+                detail::update_size(up);
+            rebalance(root, parent);
+            return root;
+        }
+    };
+
+    // No red node has a red child and every path down has the same number of black nodes,
+    // the height is below 2 log2(n + 1). Fewer rotations than avl, a slightly deeper tree.
+    struct red_black
+    {
+        static constexpr int black = 0;
+        static constexpr int red = 1;
+
+        template <typename NodeType>
+        static bool is_red(const NodeType* node)
+        {
+            return node != nullptr && node->balance == red;
+        }
+
+        template <typename NodeType>
+        static void inserted(NodeType*& root, NodeType* node)
+        {
+            node->balance = red;
+            while (is_red(node->parent))
+            {
+                // a red parent is not the root, so the grandparent exists
+                auto* parent = node->parent;
+                auto* grandparent = parent->parent;
+                const size_t side = parent->my_index;
+                auto* uncle = grandparent->children[!side];
+
+                if (is_red(uncle))
+                {
+                    parent->balance = black;
+                    uncle->balance = black;
+                    grandparent->balance = red;
+                    node = grandparent;
+                    continue;
+                }
+                if (static_cast<size_t>(node->my_index) != side)
+                {
+                    detail::rotate(root, parent, side);
+                    parent = node;
+                }
+                detail::rotate(root, grandparent, !side);
+                parent->balance = black;
+                grandparent->balance = red;
+                break;
+            }
+            root->balance = black;
+        }
+
+        template <typename NodeType>
+        static void removed(NodeType*& root, NodeType* parent, size_t index, int balance)
+        {
+            if (balance == red)
+                return;
+
+            // node carries an extra black that has to be pushed up or absorbed
+            NodeType* node = parent == nullptr ? root : parent->children[index];
+            while (node != root && !is_red(node))
+            {
+                auto* sibling = parent->children[!index];
+                if (is_red(sibling))
+                {
+                    sibling->balance = black;
+                    parent->balance = red;
+                    detail::rotate(root, parent, index);
+                    sibling = parent->children[!index];
+                }
+
+                if (!is_red(sibling->children[0]) && !is_red(sibling->children[1]))
+                {
+                    sibling->balance = red;
+                    node = parent;
+                    parent = node->parent;
+                    if (parent != nullptr)
+                        index = node->my_index;
+                    continue;
+                }
+                if (!is_red(sibling->children[!index]))
+                {
+                    sibling->children[index]->balance = black;
+                    sibling->balance = red;
+                    sibling = detail::rotate(root, sibling, !index);
+                }
+                sibling->balance = parent->balance;
+                parent->balance = black;
+                sibling->children[!index]->balance = black;
+                detail::rotate(root, parent, index);
+                node = root;
+            }
+            if (node != nullptr)
+                node->balance = black;
+        }
+
+        // only the deepest level of a perfectly balanced tree can be incomplete, it is red
+        template <typename NodeType>
+        static void built(NodeType* node, size_t depth, size_t height)
+        {
+            node->balance = depth > 0 && depth + 1 == height ? red : black;
+        }
+    };
+}
+
+
 template<
 std::totally_ordered T,
-std::relation<T, T> Compare = std::less<T>>
+std::relation<T, T> Compare = std::less<T>,
+typename Balance = balancing::avl>
 struct BinaryTree
 {
     using iterator = NodeIterator<T, 2>;
@@ -161,51 +504,42 @@ public:
     BNode* _root = nullptr;
 
     BinaryTree() = default;
+
+    // copies the nodes with their balance, without comparing anything
     BinaryTree(const BinaryTree& other)
-    {
-        auto tmp = other._pattern;
-        other.set_pattern({-1, 0, 1});
-        for (auto i : other)
-        {
-            insert(i);
-        }
-        other.set_pattern(tmp);
-    }
+        : _size(other._size), _cmp(other._cmp), _pattern(other._pattern), _root(clone(other._root))
+    {}
 
     BinaryTree(BinaryTree&& other) noexcept
     {
-        _root = std::move(other._root);
-        _size = std::move(other._size);
+        _root = std::exchange(other._root, nullptr);
+        _size = std::exchange(other._size, 0);
         _pattern = std::move(other._pattern);
     }
 
+    // O(n) for a strictly increasing range, anything else is sorted first
+    // and keeps the first of equal values
     template<std::input_iterator IteratorType>
     BinaryTree(IteratorType begin_it, IteratorType end_it)
     {
-        for (;begin_it != end_it; ++begin_it)
+        std::vector<T> values(begin_it, end_it);
+        if (std::adjacent_find(values.begin(), values.end(), [this](const T& lhs, const T& rhs)
+            { return !_cmp(lhs, rhs); }) != values.end())
         {
-            insert(*begin_it);
+            std::stable_sort(values.begin(), values.end(), _cmp);
+            values.erase(std::unique(values.begin(), values.end(), [this](const T& lhs, const T& rhs)
+                { return !_cmp(lhs, rhs); }), values.end());
         }
+        assign_sorted(values);
     }
 
     BinaryTree(std::initializer_list<T> list)
-    {
-        for (auto i : list)
-        {
-            insert(i);
-        }
-    }
+        : BinaryTree(list.begin(), list.end())
+    {}
 
     ~BinaryTree() noexcept
     {
-        _pattern = {0, 1, -1};
-        auto it = begin();
-        while(it)
-        {
-            auto tmp = it.current;
-            ++it;
-            remove(tmp);
-        }
+        clear();
     }
 
     void set_pattern(std::array<int, 3> pattern) const
@@ -218,27 +552,81 @@ public:
 
     bool insert(T value)
     {
-        auto* node = new BNode{ value };
-        if (_root == nullptr)
+        BNode* leaf = nullptr;
+        if (_root != nullptr)
         {
-            _root = node;
-            _size += 1;
-            return true;
+            auto [found, inside] = b_search(_root, value);
+            if (inside)
+                return false;
+            leaf = found;
         }
+
+        auto* node = new BNode{ std::move(value) };
+        if (leaf == nullptr)
+            _root = node;
         else
-            return insert(node);
+            leaf->link(!_cmp(node->data, leaf->data), node);
+        _size += 1;
+        balancing::detail::resize_path(leaf, true);
+        Balance::inserted(_root, node);
+        return true;
     }
 
 
     bool contains(const T& value) const
     {
-        return b_search(_root, value).second;
+        return _root != nullptr && b_search(_root, value).second;
     }
 
     bool remove(const T& value)
     {
-        auto [leaf, inside] = b_search(_root, value);
-        return ((inside) ? remove(leaf) : inside);
+        if (_root == nullptr)
+            return false;
+        auto [node, inside] = b_search(_root, value);
+        if (inside)
+            remove(node);
+        return inside;
+    }
+
+    void clear() noexcept
+    {
+        destroy(_root);
+        _root = nullptr;
+        _size = 0;
+    }
+
+    // The set operations take the nodes of other and leave it empty, pass it moved to
+    // spare the copy. For avl they split and join subtrees in O(m log(n / m + 1)) for
+    // sizes m <= n, other policies merge both sequences and build the tree again in O(n + m).
+
+    // adds the values of other
+    void unite(BinaryTree other)
+    {
+        if constexpr (has_join)
+            _root = unite(_root, std::exchange(other._root, nullptr));
+        else
+            combine(other, [](auto... arguments) { return std::set_union(arguments...); });
+        finish_combine(other);
+    }
+
+    // keeps the values that other has too
+    void intersect(BinaryTree other)
+    {
+        if constexpr (has_join)
+            _root = intersect(_root, std::exchange(other._root, nullptr));
+        else
+            combine(other, [](auto... arguments) { return std::set_intersection(arguments...); });
+        finish_combine(other);
+    }
+
+    // removes the values of other
+    void subtract(BinaryTree other)
+    {
+        if constexpr (has_join)
+            _root = subtract(_root, std::exchange(other._root, nullptr));
+        else
+            combine(other, [](auto... arguments) { return std::set_difference(arguments...); });
+        finish_combine(other);
     }
 
     iterator begin() noexcept
@@ -247,7 +635,7 @@ public:
     }
     iterator end() noexcept
     {
-        return {nullptr, _pattern};
+        return {_root, nullptr, _pattern};
     }
 
     iterator begin() const noexcept
@@ -256,58 +644,311 @@ public:
     }
     iterator end() const noexcept
     {
-        return {nullptr, _pattern};
+        return {_root, nullptr, _pattern};
+    }
+
+    // The searches below walk one path from the root, their iterators go in order
+    // whatever the pattern is, so counting k values from them takes O(log n + k).
+
+    // the first value not less than value
+    iterator lower_bound(const T& value) const
+    {
+        return bound(value, [this](const T& lhs, const T& rhs) { return !_cmp(lhs, rhs); });
+    }
+
+    // the first value greater than value
+    iterator upper_bound(const T& value) const
+    {
+        return bound(value, [this](const T& lhs, const T& rhs) { return _cmp(rhs, lhs); });
+    }
+
+    std::pair<iterator, iterator> equal_range(const T& value) const
+    {
+        return {lower_bound(value), upper_bound(value)};
+    }
+
+    // the values in [low, high)
+    std::ranges::subrange<iterator> range(const T& low, const T& high) const
+    {
+        if (!_cmp(low, high))
+            return {end_in_order(), end_in_order()};
+        return {lower_bound(low), lower_bound(high)};
+    }
+
+    // how many values are less than value
+    size_t rank(const T& value) const
+    {
+        size_t less = 0;
+        for (auto* node = _root; node != nullptr;)
+        {
+            if (_cmp(node->data, value))
+            {
+                less += balancing::detail::subtree_size(node->children[0]) + 1;
+                node = node->children[1];
+            }
+            else
+                node = node->children[0];
+        }
+        return less;
+    }
+
+    // the value with index values less than it, select(size() / 2) is the median
+    const T& select(size_t index) const
+    {
+        if (index >= _size)
+            throw std::out_of_range("in BinaryTree::select index is out of range");
+        auto* node = _root;
+        while (true)
+        {
+            const size_t left = balancing::detail::subtree_size(node->children[0]);
+            if (index == left)
+                return node->data;
+            if (index < left)
+                node = node->children[0];
+            else
+            {
+                index -= left + 1;
+                node = node->children[1];
+            }
+        }
     }
 
 private:
+    static constexpr std::array<int, 3> in_order{0, -1, 1};
+    static constexpr bool has_join = requires(BNode* node) { Balance::join(node, node, node); };
+
+    // deletes the nodes children first, without recursion
+    static void destroy(BNode* node) noexcept
+    {
+        while (node != nullptr)
+        {
+            if (node->children[0] != nullptr)
+                node = node->children[0];
+            else if (node->children[1] != nullptr)
+                node = node->children[1];
+            else
+            {
+                auto* parent = node->parent;
+                if (parent != nullptr)
+                    parent->children[node->my_index] = nullptr;
+                delete node;
+                node = parent;
+            }
+        }
+    }
 
-    bool insert(BNode* node)
+    static BNode* clone(const BNode* node)
     {
         if (node == nullptr)
-            return false;
-        auto [leaf, inside] = b_search(_root, node->data);
-        if (inside) 
-            return false;
-        leaf->link(!_cmp(node->data, leaf->data), node);
-        _size += 1;
-        return true;
+            return nullptr;
+        auto* copy = new BNode{ node->data };
+        copy->balance = node->balance;
+        copy->subtree_size = node->subtree_size;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (auto* child = clone(node->children[i]))
+                copy->link(i, child);
+        }
+        return copy;
+    }
+
+    // replaces the tree by the strictly increasing values, the middle one goes to the root
+    void assign_sorted(std::vector<T>& values)
+    {
+        clear();
+        _root = build(values, 0, values.size(), 0, std::bit_width(values.size()));
+        _size = values.size();
     }
 
-    bool remove(BNode* node) noexcept
+    static BNode* build(std::vector<T>& values, size_t begin, size_t end, size_t depth, size_t height)
     {
-        auto [left, right] = node->children;
-        if (node == _root)
+        if (begin == end)
+            return nullptr;
+        const size_t middle = begin + (end - begin) / 2;
+        auto* node = new BNode{ std::move(values[middle]) };
+        if (auto* left = build(values, begin, middle, depth + 1, height))
+            node->link(0, left);
+        if (auto* right = build(values, middle + 1, end, depth + 1, height))
+            node->link(1, right);
+        balancing::detail::update_size(node);
+        Balance::built(node, depth, height);
+        return node;
+    }
+
+    // moves the values out in order and empties the tree
+    std::vector<T> take_values()
+    {
+        std::vector<T> values;
+        values.reserve(_size);
+        for (iterator it{_root, in_order}; it != end_in_order(); ++it)
+            values.push_back(std::move(*it));
+        clear();
+        return values;
+    }
+
+    template<typename Operation>
+    void combine(BinaryTree& other, Operation operation)
+    {
+        auto lhs = take_values(), rhs = other.take_values();
+        std::vector<T> values;
+        operation(std::make_move_iterator(lhs.begin()), std::make_move_iterator(lhs.end()),
+            std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()),
+            std::back_inserter(values), _cmp);
+        assign_sorted(values);
+    }
+
+    void finish_combine(BinaryTree& other)
+    {
+        _size = balancing::detail::subtree_size(_root);
+        other._size = 0;
+    }
+
+    static BNode* detach(BNode* node)
+    {
+        if (node != nullptr)
         {
-            remove_root();
+            node->parent = nullptr;
+            node->my_index = -1;
         }
-        else
+        return node;
+    }
+
+    // the values less than value, the node of value if there is one, the values greater
+    std::tuple<BNode*, BNode*, BNode*> split(BNode* node, const T& value) const
+    {
+        if (node == nullptr)
+            return {nullptr, nullptr, nullptr};
+        auto* left = detach(node->children[0]);
+        auto* right = detach(node->children[1]);
+        node->children = {};
+
+        if (_cmp(value, node->data))
         {
-            node->unlink();
-            delete node;
-            _size -= insert(left);
-            _size -= insert(right);
-            _size -= 1;
+            auto [less, equal, greater] = split(left, value);
+            return {less, equal, Balance::join(greater, node, right)};
         }
-        return true;
+        if (_cmp(node->data, value))
+        {
+            auto [less, equal, greater] = split(right, value);
+            return {Balance::join(left, node, less), equal, greater};
+        }
+        return {left, node, right};
+    }
+
+    // the tree without its last node and that node
+    static std::pair<BNode*, BNode*> split_last(BNode* node)
+    {
+        auto* left = detach(node->children[0]);
+        auto* right = detach(node->children[1]);
+        if (right == nullptr)
+            return {left, node};
+        auto [rest, last] = split_last(right);
+        return {Balance::join(left, node, rest), last};
+    }
+
+    // every value of left is less than every value of right
+    static BNode* join(BNode* left, BNode* right)
+    {
+        if (left == nullptr)
+            return right;
+        auto [rest, last] = split_last(left);
+        return Balance::join(rest, last, right);
+    }
+
+    BNode* unite(BNode* lhs, BNode* rhs) const
+    {
+        if (lhs == nullptr)
+            return rhs;
+        if (rhs == nullptr)
+            return lhs;
+        auto* left = detach(lhs->children[0]);
+        auto* right = detach(lhs->children[1]);
+        auto [less, equal, greater] = split(rhs, lhs->data);
+        delete equal;
+        return Balance::join(unite(left, less), lhs, unite(right, greater));
     }
 
-    bool remove_root()
+    BNode* intersect(BNode* lhs, BNode* rhs) const
     {
-        auto children = _root->children;
-        auto* root = _root;
-        auto it = std::find_if(children.begin(), children.end(), [](auto x) { return x != nullptr;});
-        if (it != children.end())
+        if (lhs == nullptr || rhs == nullptr)
         {
-            _root = *it;
-            _size -= insert((it == children.begin()) ? children[1] : children[0]);
+            destroy(lhs);
+            destroy(rhs);
+            return nullptr;
         }
-        else
+        auto* left = detach(lhs->children[0]);
+        auto* right = detach(lhs->children[1]);
+        auto [less, equal, greater] = split(rhs, lhs->data);
+        auto* lower = intersect(left, less);
+        auto* upper = intersect(right, greater);
+        if (equal == nullptr)
+        {
+            delete lhs;
+            return join(lower, upper);
+        }
+        delete equal;
+        return Balance::join(lower, lhs, upper);
+    }
+
+    BNode* subtract(BNode* lhs, BNode* rhs) const
+    {
+        if (lhs == nullptr || rhs == nullptr)
+        {
+            destroy(rhs);
+            return lhs;
+        }
+        auto* left = detach(rhs->children[0]);
+        auto* right = detach(rhs->children[1]);
+        auto [less, equal, greater] = split(lhs, rhs->data);
+        delete rhs;
+        delete equal;
+        return join(subtract(less, left), subtract(greater, right));
+    }
+
+    iterator end_in_order() const
+    {
+        return {_root, nullptr, in_order};
+    }
+
+    // the first node in order that satisfies the predicate, which holds for every node after it
+    template<typename Predicate>
+    iterator bound(const T& value, Predicate satisfies) const
+    {
+        BNode* found = nullptr;
+        for (auto* node = _root; node != nullptr;)
         {
-            _root = nullptr;
+            if (satisfies(node->data, value))
+            {
+                found = node;
+                node = node->children[0];
+            }
+            else
+                node = node->children[1];
         }
-        delete root;
+        return {_root, found, in_order};
+    }
+
+    // a node with two children takes the value of its successor, which is removed instead
+    void remove(BNode* node)
+    {
+        if (node->children[0] != nullptr && node->children[1] != nullptr)
+        {
+            auto* successor = node->children[1];
+            while (successor->children[0] != nullptr)
+                successor = successor->children[0];
+            node->data = std::move(successor->data);
+            node = successor;
+        }
+
+        auto* child = node->children[0] != nullptr ? node->children[0] : node->children[1];
+        auto* parent = node->parent;
+        const size_t index = parent != nullptr ? node->my_index : 0;
+        balancing::detail::replace(_root, node, child);
+        balancing::detail::resize_path(parent, false);
+        Balance::removed(_root, parent, index, node->balance);
+
+        delete node;
         _size -= 1;
-        return true;
     }
 };
 
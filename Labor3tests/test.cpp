@@ -1,12 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <BPlusTree.hpp>
 #include <Nodes.hpp>
 
 using namespace std;
 
+#include <bit>
 #include <ctime>
 #include <functional>
+#include <map>
+#include <numeric>
 #include <random>
+#include <set>
 
 #include "testing.h"
 using namespace testing;
@@ -131,3 +136,356 @@ TEST(BinaryTree, contains_remove_insert)
     t.remove(5); 
     is_equal_collections(set<int>{}, t);
 }
+
+template<typename Tree>
+int tree_height(const Tree& tree)
+{
+    std::function<int(const Node<int, 2>*)> height = [&](const Node<int, 2>* node)
+    {
+        return node == nullptr ? 0 : 1 + std::max(height(node->children[0]), height(node->children[1]));
+    };
+    return height(tree._root);
+}
+
+template<typename Balance>
+void check_sorted_input_height(double bound)
+{
+    const int count = 1 << 14;
+    BinaryTree<int, std::less<int>, Balance> t;
+    for (int i = 0; i < count; ++i)
+        t.insert(i);
+    EXPECT_EQ(t.size(), count);
+    EXPECT_LE(tree_height(t), bound * std::log2(count + 2));
+
+    for (int i = 0; i < count; i += 2)
+        EXPECT_TRUE(t.remove(i));
+    EXPECT_LE(tree_height(t), bound * std::log2(count / 2 + 2));
+}
+
+TEST(BinaryTree, avl_sorted_input_height)
+{
+    check_sorted_input_height<balancing::avl>(1.45);
+}
+
+TEST(BinaryTree, red_black_sorted_input_height)
+{
+    check_sorted_input_height<balancing::red_black>(2);
+}
+
+template<typename Balance>
+void check_remove_keeps_values()
+{
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> values(0, 2000);
+    BinaryTree<int, std::less<int>, Balance> t;
+    std::set<int> correct;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        const int value = values(gen);
+        if (i % 3 == 0)
+            EXPECT_EQ(t.remove(value), correct.erase(value) == 1);
+        else
+            EXPECT_EQ(t.insert(value), correct.insert(value).second);
+    }
+
+    EXPECT_EQ(t.size(), correct.size());
+    EXPECT_TRUE(std::equal(t.begin(), t.end(), correct.begin(), correct.end()));
+    for (int value : correct)
+        EXPECT_TRUE(t.contains(value));
+}
+
+TEST(BinaryTree, avl_remove_keeps_values)
+{
+    check_remove_keeps_values<balancing::avl>();
+}
+
+TEST(BinaryTree, red_black_remove_keeps_values)
+{
+    check_remove_keeps_values<balancing::red_black>();
+}
+
+TEST(BinaryTree, iterator_patterns)
+{
+    std::vector<int> data(1000);
+    std::generate(data.begin(), data.end(), random_generator<int>{});
+    BinaryTree t(data.begin(), data.end());
+
+    for (std::array<int, 3> pattern : {std::array{0, -1, 1}, std::array{-1, 0, 1}, std::array{0, 1, -1}, std::array{1, -1, 0}})
+    {
+        std::vector<int> correct;
+        std::function<void(const Node<int, 2>*)> visit = [&](const Node<int, 2>* node)
+        {
+            if (node == nullptr)
+                return;
+            for (int step : pattern)
+            {
+                if (step == -1)
+                    correct.push_back(node->data);
+                else
+                    visit(node->children[step]);
+            }
+        };
+        visit(t._root);
+
+        t.set_pattern(pattern);
+        EXPECT_TRUE(std::equal(t.begin(), t.end(), correct.begin(), correct.end()));
+
+        std::vector<int> backward;
+        for (auto it = t.end(); it != t.begin();)
+            backward.push_back(*--it);
+        EXPECT_TRUE(std::equal(backward.rbegin(), backward.rend(), correct.begin(), correct.end()));
+    }
+
+    BinaryTree<int> empty;
+    EXPECT_TRUE(empty.begin() == empty.end());
+    EXPECT_FALSE(empty.begin());
+}
+
+template<typename Balance>
+void check_range_queries()
+{
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> values(0, 3000);
+    BinaryTree<int, std::less<int>, Balance> t;
+    std::set<int> correct;
+    for (int i = 0; i < 6000; ++i)
+    {
+        const int value = values(gen);
+        if (i % 4 == 0)
+        {
+            t.remove(value);
+            correct.erase(value);
+        }
+        else
+        {
+            t.insert(value);
+            correct.insert(value);
+        }
+    }
+    // the queries go in order whatever the pattern is
+    t.set_pattern({-1, 0, 1});
+
+    const std::vector<int> sorted(correct.begin(), correct.end());
+    for (int value = -1; value <= 3001; ++value)
+    {
+        auto lower = t.lower_bound(value);
+        auto correct_lower = correct.lower_bound(value);
+        EXPECT_EQ(lower == t.end(), correct_lower == correct.end());
+        if (correct_lower != correct.end())
+            EXPECT_EQ(*lower, *correct_lower);
+
+        auto [first, last] = t.equal_range(value);
+        EXPECT_EQ(std::distance(first, last), correct.count(value));
+        auto upper = t.upper_bound(value);
+        auto correct_upper = correct.upper_bound(value);
+        EXPECT_EQ(upper == t.end(), correct_upper == correct.end());
+        if (correct_upper != correct.end())
+            EXPECT_EQ(*upper, *correct_upper);
+
+        EXPECT_EQ(t.rank(value), std::distance(correct.begin(), correct_lower));
+    }
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+        EXPECT_EQ(t.select(i), sorted[i]);
+    EXPECT_THROW(t.select(sorted.size()), std::out_of_range);
+
+    auto inside = t.range(1000, 2000);
+    EXPECT_TRUE(std::ranges::equal(inside, std::ranges::subrange(correct.lower_bound(1000), correct.lower_bound(2000))));
+    EXPECT_TRUE(std::ranges::empty(t.range(2000, 1000)));
+}
+
+TEST(BinaryTree, avl_range_queries)
+{
+    check_range_queries<balancing::avl>();
+}
+
+TEST(BinaryTree, red_black_range_queries)
+{
+    check_range_queries<balancing::red_black>();
+}
+
+template<typename Balance>
+void check_bulk_construction()
+{
+    std::vector<int> sorted(100000);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    BinaryTree<int, std::less<int>, Balance> t(sorted.begin(), sorted.end());
+    EXPECT_EQ(t.size(), sorted.size());
+    EXPECT_EQ(tree_height(t), std::bit_width(sorted.size()));
+    EXPECT_TRUE(std::equal(t.begin(), t.end(), sorted.begin(), sorted.end()));
+
+    // a built tree stays balanced under later changes
+    for (int i = 0; i < 100000; i += 2)
+        EXPECT_TRUE(t.remove(i));
+    for (int i = 100000; i < 150000; ++i)
+        EXPECT_TRUE(t.insert(i));
+    EXPECT_LE(tree_height(t), 2 * std::log2(t.size() + 1));
+
+    const auto copy = t;
+    EXPECT_EQ(copy.size(), t.size());
+    EXPECT_EQ(tree_height(copy), tree_height(t));
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), t.begin(), t.end()));
+    EXPECT_EQ(copy.select(1000), t.select(1000));
+
+    BinaryTree<int, std::less<int>, Balance> unsorted{5, 1, 4, 1, 3};
+    EXPECT_TRUE(is_equal_collections(unsorted, set{1, 3, 4, 5}));
+}
+
+TEST(BinaryTree, avl_bulk_construction)
+{
+    check_bulk_construction<balancing::avl>();
+}
+
+TEST(BinaryTree, red_black_bulk_construction)
+{
+    check_bulk_construction<balancing::red_black>();
+}
+
+template<typename Balance>
+void check_set_algebra()
+{
+    using tree = BinaryTree<int, std::less<int>, Balance>;
+    std::mt19937 gen(3);
+    for (auto [lhs_size, rhs_size] : {std::pair{2000, 2000}, std::pair{5000, 50}, std::pair{30, 4000}, std::pair{0, 100}})
+    {
+        std::uniform_int_distribution<> values(0, 6000);
+        std::set<int> lhs, rhs;
+        for (int i = 0; i < lhs_size; ++i)
+            lhs.insert(values(gen));
+        for (int i = 0; i < rhs_size; ++i)
+            rhs.insert(values(gen));
+
+        std::vector<int> correct;
+        tree united(lhs.begin(), lhs.end());
+        united.unite(tree(rhs.begin(), rhs.end()));
+        std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(correct));
+        EXPECT_EQ(united.size(), correct.size());
+        EXPECT_TRUE(std::equal(united.begin(), united.end(), correct.begin(), correct.end()));
+
+        correct.clear();
+        tree intersected(lhs.begin(), lhs.end());
+        intersected.intersect(tree(rhs.begin(), rhs.end()));
+        std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(correct));
+        EXPECT_EQ(intersected.size(), correct.size());
+        EXPECT_TRUE(std::equal(intersected.begin(), intersected.end(), correct.begin(), correct.end()));
+
+        correct.clear();
+        tree subtracted(lhs.begin(), lhs.end());
+        tree other(rhs.begin(), rhs.end());
+        subtracted.subtract(other);
+        std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(correct));
+        EXPECT_EQ(subtracted.size(), correct.size());
+        EXPECT_TRUE(std::equal(subtracted.begin(), subtracted.end(), correct.begin(), correct.end()));
+        EXPECT_EQ(other.size(), rhs.size());
+
+        for (auto* result : {&united, &intersected, &subtracted})
+        {
+            EXPECT_LE(tree_height(*result), 2 * std::log2(result->size() + 1));
+            if (result->size() > 0)
+                EXPECT_EQ(result->rank(result->select(result->size() / 2)), result->size() / 2);
+        }
+    }
+}
+
+TEST(BinaryTree, avl_set_algebra)
+{
+    check_set_algebra<balancing::avl>();
+}
+
+TEST(BinaryTree, red_black_set_algebra)
+{
+    check_set_algebra<balancing::red_black>();
+}
+
+TEST(BPlusTree, insert_erase)
+{
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<> values(0, 5000);
+    BPlusSet<int> t;
+    std::set<int> correct;
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        const int value = values(gen);
+        if (i % 3 == 0)
+            EXPECT_EQ(t.erase(value), correct.erase(value) == 1);
+        else
+            EXPECT_EQ(t.insert(value), correct.insert(value).second);
+    }
+
+    EXPECT_EQ(t.size(), correct.size());
+    EXPECT_TRUE(std::equal(t.begin(), t.end(), correct.begin(), correct.end()));
+    for (int value = -1; value <= 5001; ++value)
+    {
+        EXPECT_EQ(t.contains(value), correct.contains(value));
+        auto lower = t.lower_bound(value);
+        auto correct_lower = correct.lower_bound(value);
+        EXPECT_EQ(lower == t.end(), correct_lower == correct.end());
+        if (correct_lower != correct.end())
+            EXPECT_EQ(*lower, *correct_lower);
+    }
+
+    std::vector<int> backward;
+    for (auto it = t.end(); it != t.begin();)
+        backward.push_back(*--it);
+    EXPECT_TRUE(std::equal(backward.rbegin(), backward.rend(), correct.begin(), correct.end()));
+
+    for (int value : std::vector<int>(correct.begin(), correct.end()))
+        EXPECT_TRUE(t.erase(value));
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.begin() == t.end());
+}
+
+TEST(BPlusTree, bulk_load)
+{
+    std::vector<int> sorted(100000);
+    for (int i = 0; i < 100000; ++i)
+        sorted[i] = 2 * i;
+
+    BPlusSet<int> t;
+    t.bulk_load(sorted.begin(), sorted.end());
+    EXPECT_EQ(t.size(), sorted.size());
+    EXPECT_TRUE(std::equal(t.begin(), t.end(), sorted.begin(), sorted.end()));
+    EXPECT_LE(t.height(), 4);
+
+    for (int i = 1; i < 200000; i += 2)
+        EXPECT_TRUE(t.insert(i));
+    for (int i = 0; i < 200000; i += 3)
+        EXPECT_TRUE(t.erase(i));
+    size_t count = 0;
+    for (int value : t)
+    {
+        EXPECT_NE(value % 3, 0);
+        count += 1;
+    }
+    EXPECT_EQ(count, t.size());
+
+    std::vector<int> unsorted{1, 3, 2};
+    EXPECT_THROW(t.bulk_load(unsorted.begin(), unsorted.end()), std::invalid_argument);
+}
+
+TEST(BPlusTree, map)
+{
+    BPlusMap<int, std::string> t;
+    std::map<int, std::string> correct;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int key = (i * 7919) % 10007;
+        t[key] = std::to_string(i);
+        correct[key] = std::to_string(i);
+    }
+
+    auto it = t.begin();
+    for (const auto& [key, value] : correct)
+    {
+        EXPECT_EQ(it.key(), key);
+        EXPECT_EQ(it.value(), value);
+        ++it;
+    }
+    EXPECT_TRUE(it == t.end());
+
+    const auto copy = t;
+    EXPECT_EQ(copy.at(7919), "1");
+    EXPECT_THROW(copy.at(-1), std::out_of_range);
+}
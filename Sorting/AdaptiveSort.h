@@ -0,0 +1,214 @@
+#pragma once
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SortTraits.h"
+#include "SortingNetworks.h"
+#include "PdqSort.h"
+#include "MergeSort.h"
+#include "RadixSort.h"
+#include "ParallelSort.h"
+
+
+namespace sorting
+{
+	enum class sort_engine { none, network, insertion, merge, radix, pdq, parallel_sample, buffered, member };
+
+	inline const char* to_string(sort_engine engine) noexcept
+	{
+		switch (engine)
+		{
+		case sort_engine::none: return "none";
+		case sort_engine::network: return "NetworkSort";
+		case sort_engine::insertion: return "insertion sort";
+		case sort_engine::merge: return "MergeSort";
+		case sort_engine::radix: return "RadixSort";
+		case sort_engine::pdq: return "PdqSort";
+		case sort_engine::parallel_sample: return "ParallelSampleSort";
+		case sort_engine::buffered: return "vector buffer";
+		case sort_engine::member: return "member sort";
+		}
+		return "unknown";
+	}
+
+	struct sort_decision
+	{
+		sort_engine engine;
+		size_t size;
+		// why the engine was picked, a string literal
+		const char* reason;
+	};
+
+	// called once for every decision Sort makes, a buffered range reports two
+	using sort_trace = std::function<void(const sort_decision&)>;
+
+	namespace detail
+	{
+		namespace dispatch
+		{
+			inline constexpr ptrdiff_t insertion_threshold = 24;
+			inline constexpr ptrdiff_t probe_threshold = 256;
+			inline constexpr ptrdiff_t probe_samples = 64;
+			inline constexpr ptrdiff_t lsd_radix_threshold = 4096;
+			inline constexpr ptrdiff_t msd_radix_threshold = 1024;
+			inline constexpr ptrdiff_t parallel_threshold = ptrdiff_t(1) << 22;
+
+			template<typename T, typename Comparator>
+			inline constexpr bool is_ascending = std::is_same_v<Comparator, std::less<T>> || std::is_same_v<Comparator, std::less<>>;
+
+			// LSD passes copy every element a few times, so only small trivially copyable keys qualify
+			template<typename T, typename Comparator>
+			inline constexpr bool is_lsd_sortable =
+				is_ascending<T, Comparator> && radix::lsd_key<T> && std::is_trivially_copyable_v<T> && sizeof(T) <= 8;
+
+			template<typename T, typename Comparator>
+			inline constexpr bool is_msd_sortable = is_ascending<T, Comparator> && radix::msd_key<const T&>;
+
+			enum class presortedness { unknown, ascending, descending };
+
+			// Looks at probe_samples adjacent pairs spread over the range. No pair out of order in
+			// either direction suggests long runs, which MergeSort takes in O(n).
+			template<typename Iterator, typename Comparator>
+			presortedness probe(Iterator begin_it, ptrdiff_t size, Comparator& cmp)
+			{
+				const ptrdiff_t step = (size - 1) / probe_samples;
+				ptrdiff_t ascending = 0, descending = 0;
+				for (ptrdiff_t i = 0; i < probe_samples; ++i)
+				{
+					Iterator pair = begin_it + i * step;
+					if (cmp(*(pair + 1), *pair))
+						++descending;
+					else if (cmp(*pair, *(pair + 1)))
+						++ascending;
+				}
+				if (descending == 0)
+					return presortedness::ascending;
+				if (ascending == 0)
+					return presortedness::descending;
+				return presortedness::unknown;
+			}
+
+			template<std::random_access_iterator Iterator, typename Comparator>
+			void sort(Iterator begin_it, Iterator end_it, Comparator& cmp, const sort_trace& trace)
+			{
+				using value_type = iter_value<Iterator>;
+				const ptrdiff_t size = end_it - begin_it;
+				auto decide = [&](sort_engine engine, const char* reason)
+				{
+					if (trace)
+						trace({ engine, static_cast<size_t>(size), reason });
+				};
+
+				if (size < 2)
+				{
+					decide(sort_engine::none, "sorted by definition");
+					return;
+				}
+
+				if constexpr (network::is_network_sortable<Iterator, Comparator>)
+				{
+					if (size <= static_cast<ptrdiff_t>(network_max_size))
+					{
+						decide(sort_engine::network, "few contiguous int, float or double");
+						network::sort(std::to_address(begin_it), static_cast<size_t>(size));
+						return;
+					}
+				}
+
+				if (size < insertion_threshold)
+				{
+					decide(sort_engine::insertion, "few elements");
+					pdq::insertion_sort(begin_it, end_it, cmp);
+					return;
+				}
+
+				if (size >= probe_threshold)
+				{
+					const presortedness order = probe(begin_it, size, cmp);
+					if (order != presortedness::unknown)
+					{
+						decide(sort_engine::merge, order == presortedness::ascending ? "probe found ascending runs" : "probe found descending runs");
+						merge::tim_sort(begin_it, end_it, cmp);
+						return;
+					}
+				}
+
+				if constexpr (is_lsd_sortable<value_type, Comparator>)
+				{
+					if (size >= lsd_radix_threshold)
+					{
+						decide(sort_engine::radix, "many small numeric keys");
+						RadixSort(begin_it, end_it);
+						return;
+					}
+				}
+				else if constexpr (is_msd_sortable<value_type, Comparator>)
+				{
+					if (size >= msd_radix_threshold)
+					{
+						decide(sort_engine::radix, "many string keys");
+						RadixSort(begin_it, end_it);
+						return;
+					}
+				}
+
+				if (size >= parallel_threshold && std::thread::hardware_concurrency() > 1)
+				{
+					decide(sort_engine::parallel_sample, "large range and several cores");
+					ParallelSampleSort(begin_it, end_it, cmp);
+					return;
+				}
+
+				decide(sort_engine::pdq, "general case");
+				PdqSort(begin_it, end_it, cmp);
+			}
+
+			template<typename Range, typename Comparator>
+			concept has_member_sort = requires(Range& range, Comparator cmp) { range.sort(cmp); };
+		}
+	}
+
+
+	// Unstable. Picks an engine by iterator category, element type, comparator, size and a
+	// sample of the order already present, every decision goes to trace when it is set.
+	// Non random access ranges are sorted in a vector and moved back.
+	template<std::bidirectional_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void Sort(Iterator begin_it, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{}, const sort_trace& trace = {})
+	{
+		if constexpr (std::random_access_iterator<Iterator>)
+			detail::dispatch::sort(begin_it, end_it, cmp, trace);
+		else
+		{
+			std::vector<iter_value<Iterator>> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+			if (trace)
+				trace({ sort_engine::buffered, buffer.size(), "no random access" });
+			detail::dispatch::sort(buffer.begin(), buffer.end(), cmp, trace);
+			std::move(buffer.begin(), buffer.end(), begin_it);
+		}
+	}
+
+	// Containers with their own sort, like linked_list and std::list, relink their nodes
+	// instead of moving the values, the rest go to the iterator version.
+	template<std::ranges::bidirectional_range Range,
+	iter_compare<std::ranges::iterator_t<Range>> Comparator = std::less<std::ranges::range_value_t<Range>>>
+	void Sort(Range& range, Comparator cmp = std::less<std::ranges::range_value_t<Range>>{}, const sort_trace& trace = {})
+	{
+		if constexpr (detail::dispatch::has_member_sort<Range, Comparator>)
+		{
+			if (trace)
+				trace({ sort_engine::member, static_cast<size_t>(std::ranges::distance(range)), "container sorts by relinking" });
+			range.sort(cmp);
+		}
+		else
+			Sort(std::ranges::begin(range), std::ranges::end(range), cmp, trace);
+	}
+}
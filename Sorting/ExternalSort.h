@@ -0,0 +1,469 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "PdqSort.h"
+
+
+namespace sorting
+{
+	struct external_options
+	{
+		// bytes of records held in memory while runs are generated, also split between merge buffers
+		size_t memory_budget = size_t(256) << 20;
+		// bytes read or written by one file access
+		size_t buffer_size = size_t(1) << 20;
+		std::filesystem::path temp_directory = std::filesystem::temp_directory_path();
+	};
+
+	struct external_stats
+	{
+		using duration = std::chrono::steady_clock::duration;
+
+		size_t records = 0;
+		size_t runs = 0;
+		// k-way merges, the last one writes the output
+		size_t merges = 0;
+		size_t bytes_read = 0;
+		size_t bytes_written = 0;
+		duration total_time{};
+		// time spent inside file reads and writes
+		duration io_time{};
+
+		// bytes per second over the whole sort
+		[[nodiscard]] double throughput() const noexcept
+		{
+			return per_second(bytes_read + bytes_written, total_time);
+		}
+
+		// bytes per second over the time spent in file accesses only
+		[[nodiscard]] double io_throughput() const noexcept
+		{
+			return per_second(bytes_read + bytes_written, io_time);
+		}
+
+	private:
+		static double per_second(size_t bytes, duration time) noexcept
+		{
+			const double seconds = std::chrono::duration<double>(time).count();
+			return seconds > 0 ? static_cast<double>(bytes) / seconds : 0.0;
+		}
+	};
+
+	namespace detail
+	{
+		// Records are sorted in runs that fit the memory budget, runs are spilled to temporary
+		// files and merged by a loser tree, with as many passes as the budget of merge buffers needs.
+		namespace external
+		{
+			class buffered_reader
+			{
+			public:
+				buffered_reader(const std::filesystem::path& path, size_t buffer_size, external_stats& stats)
+					: file_(path, std::ios::binary), buffer_(std::max<size_t>(buffer_size, 1)), stats_(stats)
+				{
+					if (!file_)
+						throw std::runtime_error("in ExternalSort can't open " + path.string() + " for reading");
+				}
+
+				// false when the file ended before the record began
+				bool read(char* data, size_t size)
+				{
+					for (size_t done = 0; done < size;)
+					{
+						if (position_ == filled_ && !refill())
+						{
+							if (done == 0)
+								return false;
+							throw std::runtime_error("in ExternalSort file ends inside a record");
+						}
+						const size_t count = std::min(size - done, filled_ - position_);
+						std::memcpy(data + done, buffer_.data() + position_, count);
+						position_ += count;
+						done += count;
+					}
+					return true;
+				}
+
+				// the line without its '\n', false when the file ended before the line began
+				bool read_line(std::string& line)
+				{
+					line.clear();
+					while (true)
+					{
+						if (position_ == filled_ && !refill())
+							return !line.empty();
+
+						const char* begin = buffer_.data() + position_;
+						const char* end = buffer_.data() + filled_;
+						const char* newline = std::find(begin, end, '\n');
+						line.append(begin, newline);
+						position_ = newline - buffer_.data();
+						if (newline != end)
+						{
+							++position_;
+							return true;
+						}
+					}
+				}
+
+			private:
+				bool refill()
+				{
+					const auto start = std::chrono::steady_clock::now();
+					file_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+					stats_.io_time += std::chrono::steady_clock::now() - start;
+
+					filled_ = static_cast<size_t>(file_.gcount());
+					position_ = 0;
+					stats_.bytes_read += filled_;
+					if (filled_ == 0 && file_.bad())
+						throw std::runtime_error("in ExternalSort reading failed");
+					return filled_ != 0;
+				}
+
+				std::ifstream file_;
+				std::vector<char> buffer_;
+				size_t position_ = 0;
+				size_t filled_ = 0;
+				external_stats& stats_;
+			};
+
+			class buffered_writer
+			{
+			public:
+				buffered_writer(const std::filesystem::path& path, size_t buffer_size, external_stats& stats)
+					: file_(path, std::ios::binary | std::ios::trunc), stats_(stats)
+				{
+					if (!file_)
+						throw std::runtime_error("in ExternalSort can't open " + path.string() + " for writing");
+					buffer_.reserve(std::max<size_t>(buffer_size, 1));
+				}
+
+				void write(const char* data, size_t size)
+				{
+					if (buffer_.size() + size > buffer_.capacity())
+						flush();
+					if (size > buffer_.capacity())
+						write_through(data, size);
+					else
+						buffer_.insert(buffer_.end(), data, data + size);
+				}
+
+				// data is on disk after it, errors surface here rather than in the destructor
+				void close()
+				{
+					flush();
+					file_.close();
+					if (file_.fail())
+						throw std::runtime_error("in ExternalSort writing failed");
+				}
+
+			private:
+				void flush()
+				{
+					write_through(buffer_.data(), buffer_.size());
+					buffer_.clear();
+				}
+
+				void write_through(const char* data, size_t size)
+				{
+					const auto start = std::chrono::steady_clock::now();
+					file_.write(data, static_cast<std::streamsize>(size));
+					stats_.io_time += std::chrono::steady_clock::now() - start;
+
+					stats_.bytes_written += size;
+					if (!file_)
+						throw std::runtime_error("in ExternalSort writing failed");
+				}
+
+				std::ofstream file_;
+				std::vector<char> buffer_;
+				external_stats& stats_;
+			};
+
+			// records of sizeof(T) bytes copied as they are in memory
+			template<typename T>
+			struct fixed_records
+			{
+				using value_type = T;
+
+				static bool read(buffered_reader& reader, T& value)
+				{
+					return reader.read(reinterpret_cast<char*>(&value), sizeof(T));
+				}
+
+				static void write(buffered_writer& writer, const T& value)
+				{
+					writer.write(reinterpret_cast<const char*>(&value), sizeof(T));
+				}
+
+				static size_t footprint(const T&) noexcept
+				{
+					return sizeof(T);
+				}
+			};
+
+			// '\n' terminated lines, a last line without one gets it in the output
+			struct line_records
+			{
+				using value_type = std::string;
+
+				static bool read(buffered_reader& reader, std::string& line)
+				{
+					return reader.read_line(line);
+				}
+
+				static void write(buffered_writer& writer, const std::string& line)
+				{
+					writer.write(line.data(), line.size());
+					writer.write("\n", 1);
+				}
+
+				static size_t footprint(const std::string& line) noexcept
+				{
+					return sizeof(std::string) + line.capacity();
+				}
+			};
+
+			// Internal nodes keep the loser of the match played there, tree_[0] the overall
+			// winner. Replacing the winner's record replays only the path from its leaf.
+			template<typename Record, typename Comparator>
+			class loser_tree
+			{
+				using value_type = typename Record::value_type;
+
+				struct source
+				{
+					buffered_reader reader;
+					value_type head;
+					bool active;
+				};
+
+			public:
+				loser_tree(const std::vector<std::filesystem::path>& runs, size_t buffer_size,
+					Comparator& cmp, external_stats& stats)
+					: cmp_(cmp), tree_(runs.size())
+				{
+					sources_.reserve(runs.size());
+					for (const auto& run : runs)
+					{
+						sources_.push_back({ buffered_reader(run, buffer_size, stats), value_type{}, false });
+						source& added = sources_.back();
+						added.active = Record::read(added.reader, added.head);
+					}
+					tree_[0] = build(1);
+				}
+
+				[[nodiscard]] bool empty() const noexcept
+				{
+					return !sources_[tree_[0]].active;
+				}
+
+				[[nodiscard]] const value_type& top() const noexcept
+				{
+					return sources_[tree_[0]].head;
+				}
+
+				void pop()
+				{
+					const size_t leaf = tree_[0];
+					source& winner = sources_[leaf];
+					winner.active = Record::read(winner.reader, winner.head);
+
+					size_t current = leaf;
+					for (size_t node = (leaf + sources_.size()) / 2; node > 0; node /= 2)
+					{
+						if (beats(tree_[node], current))
+							std::swap(tree_[node], current);
+					}
+					tree_[0] = current;
+				}
+
+			private:
+				// exhausted sources lose, ties go to the earlier run
+				bool beats(size_t left, size_t right) const
+				{
+					if (!sources_[left].active || !sources_[right].active)
+						return sources_[left].active;
+					if (cmp_(sources_[left].head, sources_[right].head))
+						return true;
+					if (cmp_(sources_[right].head, sources_[left].head))
+						return false;
+					return left < right;
+				}
+
+				// nodes k ... 2k - 1 are the leaves
+				size_t build(size_t node)
+				{
+					if (node >= sources_.size())
+						return node - sources_.size();
+
+					const size_t left = build(2 * node), right = build(2 * node + 1);
+					if (beats(left, right))
+					{
+						tree_[node] = right;
+						return left;
+					}
+					tree_[node] = left;
+					return right;
+				}
+
+				Comparator& cmp_;
+				std::vector<source> sources_;
+				std::vector<size_t> tree_;
+			};
+
+			// removes every file it handed out, also when the sort throws
+			class temp_files
+			{
+			public:
+				explicit temp_files(std::filesystem::path directory)
+					: directory_(std::move(directory)), tag_(std::random_device{}())
+				{
+				}
+
+				temp_files(const temp_files&) = delete;
+				temp_files& operator=(const temp_files&) = delete;
+
+				~temp_files()
+				{
+					for (const auto& path : paths_)
+					{
+						std::error_code ignored;
+						std::filesystem::remove(path, ignored);
+					}
+				}
+
+				std::filesystem::path create()
+				{
+					paths_.push_back(directory_ / ("external_sort_" + std::to_string(tag_) + "_" + std::to_string(paths_.size()) + ".tmp"));
+					return paths_.back();
+				}
+
+				static void remove(const std::filesystem::path& path)
+				{
+					std::error_code ignored;
+					std::filesystem::remove(path, ignored);
+				}
+
+			private:
+				std::filesystem::path directory_;
+				unsigned tag_;
+				std::vector<std::filesystem::path> paths_;
+			};
+
+			template<typename Record, typename Comparator>
+			void merge_runs(const std::vector<std::filesystem::path>& runs, const std::filesystem::path& output,
+				Comparator& cmp, const external_options& options, external_stats& stats)
+			{
+				loser_tree<Record, Comparator> tree(runs, options.buffer_size, cmp, stats);
+				buffered_writer writer(output, options.buffer_size, stats);
+				for (; !tree.empty(); tree.pop())
+					Record::write(writer, tree.top());
+				writer.close();
+			}
+
+			template<typename Record, typename Comparator>
+			external_stats external_sort(const std::filesystem::path& input, const std::filesystem::path& output,
+				Comparator& cmp, const external_options& options)
+			{
+				using value_type = typename Record::value_type;
+				const auto start = std::chrono::steady_clock::now();
+
+				external_stats stats;
+				temp_files temp(options.temp_directory);
+				std::vector<std::filesystem::path> runs;
+
+				{
+					buffered_reader reader(input, options.buffer_size, stats);
+					std::vector<value_type> records;
+					value_type record{};
+					bool input_left = Record::read(reader, record);
+
+					// a run that holds the whole input goes straight to the output
+					while (input_left || runs.empty())
+					{
+						size_t footprint = 0;
+						records.clear();
+						while (input_left && (records.empty() || footprint < options.memory_budget))
+						{
+							footprint += Record::footprint(record);
+							records.push_back(std::move(record));
+							input_left = Record::read(reader, record);
+						}
+
+						PdqSort(records.begin(), records.end(), cmp);
+						stats.records += records.size();
+
+						const auto path = !input_left && runs.empty() ? output : temp.create();
+						buffered_writer writer(path, options.buffer_size, stats);
+						for (const auto& sorted : records)
+							Record::write(writer, sorted);
+						writer.close();
+						runs.push_back(path);
+					}
+				}
+				stats.runs = runs.size();
+
+				if (runs.size() > 1)
+				{
+					// every merged run needs an input buffer, the output one more
+					const size_t fan_in = std::max<size_t>(2, options.memory_budget / std::max<size_t>(options.buffer_size, 1) - 1);
+					size_t first = 0;
+					while (runs.size() - first > fan_in)
+					{
+						const size_t last = first + fan_in;
+						std::vector<std::filesystem::path> group(runs.begin() + first, runs.begin() + last);
+						const auto merged = temp.create();
+						merge_runs<Record>(group, merged, cmp, options, stats);
+						for (const auto& path : group)
+							temp_files::remove(path);
+						runs.push_back(merged);
+						first = last;
+						++stats.merges;
+					}
+
+					merge_runs<Record>({ runs.begin() + first, runs.end() }, output, cmp, options, stats);
+					++stats.merges;
+				}
+
+				stats.total_time = std::chrono::steady_clock::now() - start;
+				return stats;
+			}
+		}
+	}
+
+
+	// Sorts a binary file of trivially copyable records of sizeof(T) bytes into output using
+	// about options.memory_budget bytes of memory. Runs are sorted with PdqSort, spilled to
+	// options.temp_directory and merged, so the sort is not stable.
+	template<typename T, typename Comparator = std::less<T>>
+	requires std::is_trivially_copyable_v<T> && std::relation<Comparator&, const T&, const T&>
+	external_stats ExternalSort(const std::filesystem::path& input, const std::filesystem::path& output,
+		Comparator cmp = Comparator{}, const external_options& options = {})
+	{
+		return detail::external::external_sort<detail::external::fixed_records<T>>(input, output, cmp, options);
+	}
+
+	// the same for a text file of '\n' terminated lines
+	template<typename Comparator = std::less<std::string>>
+	requires std::relation<Comparator&, const std::string&, const std::string&>
+	external_stats ExternalSortLines(const std::filesystem::path& input, const std::filesystem::path& output,
+		Comparator cmp = Comparator{}, const external_options& options = {})
+	{
+		return detail::external::external_sort<detail::external::line_records>(input, output, cmp, options);
+	}
+}
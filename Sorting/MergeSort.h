@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "SortTraits.h"
+#include "SortingNetworks.h"
+
+
+namespace sorting
+{
+	namespace detail
+	{
+		// Bottom-up natural merge sort in the spirit of TimSort: ascending and strictly
+		// descending runs are detected and extended to min_run by binary insertion, runs are
+		// merged by the stack invariants and the merges switch to galloping when one side
+		// keeps winning. Every merge goes through one buffer of n / 2 elements.
+		namespace merge
+		{
+			inline constexpr ptrdiff_t min_merge = 32;
+			inline constexpr ptrdiff_t initial_min_gallop = 7;
+
+			// n / 2^k rounded up so that n / min_run is a power of two or slightly less
+			inline ptrdiff_t min_run_length(ptrdiff_t size)
+			{
+				ptrdiff_t rest = 0;
+				while (size >= min_merge)
+				{
+					rest |= size & 1;
+					size >>= 1;
+				}
+				return size + rest;
+			}
+
+			// Exponential search from the front for the first element not satisfying before,
+			// O(log k) where k is the answer.
+			template<typename Iterator, typename Predicate>
+			Iterator gallop_from_begin(Iterator begin_it, Iterator end_it, Predicate before)
+			{
+				const ptrdiff_t length = end_it - begin_it;
+				ptrdiff_t bound = 1;
+				while (bound <= length && before(begin_it[bound - 1]))
+					bound *= 2;
+				return std::partition_point(begin_it + bound / 2, begin_it + std::min(bound, length), before);
+			}
+
+			// the same search starting from the back
+			template<typename Iterator, typename Predicate>
+			Iterator gallop_from_end(Iterator begin_it, Iterator end_it, Predicate before)
+			{
+				const ptrdiff_t length = end_it - begin_it;
+				ptrdiff_t bound = 1;
+				while (bound <= length && !before(end_it[-bound]))
+					bound *= 2;
+				return std::partition_point(end_it - std::min(bound, length), end_it - bound / 2, before);
+			}
+
+			// [begin_it, sorted_end) is sorted already
+			template<typename Iterator, typename Comparator>
+			void binary_insertion_sort(Iterator begin_it, Iterator sorted_end, Iterator end_it, Comparator& cmp)
+			{
+				for (; sorted_end != end_it; ++sorted_end)
+				{
+					Iterator position = std::upper_bound(begin_it, sorted_end, *sorted_end, cmp);
+					if (position == sorted_end)
+						continue;
+
+					iter_value<Iterator> tmp = std::move(*sorted_end);
+					std::move_backward(position, sorted_end, sorted_end + 1);
+					*position = std::move(tmp);
+				}
+			}
+
+			// a strictly descending run is reversed, which keeps the sort stable
+			template<typename Iterator, typename Comparator>
+			ptrdiff_t count_run(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				Iterator run_end = begin_it + 1;
+				if (run_end == end_it)
+					return 1;
+
+				if (cmp(*run_end, *begin_it))
+				{
+					while (++run_end != end_it && cmp(*run_end, *(run_end - 1)));
+					std::reverse(begin_it, run_end);
+				}
+				else
+					while (++run_end != end_it && !cmp(*run_end, *(run_end - 1)));
+
+				return run_end - begin_it;
+			}
+
+			template<typename Iterator, typename Comparator>
+			class merge_state
+			{
+				using value_type = iter_value<Iterator>;
+				using buffer_iterator = typename std::vector<value_type>::iterator;
+
+				struct run
+				{
+					Iterator begin_it;
+					ptrdiff_t length;
+				};
+
+			public:
+				merge_state(ptrdiff_t size, Comparator& cmp)
+					: cmp_(cmp)
+				{
+					buffer_.reserve(size / 2);
+				}
+
+				void push_run(Iterator begin_it, ptrdiff_t length)
+				{
+					runs_.push_back({ begin_it, length });
+				}
+
+				// keeps run lengths decreasing faster than the Fibonacci numbers
+				void merge_collapse()
+				{
+					while (runs_.size() > 1)
+					{
+						size_t n = runs_.size() - 2;
+						if ((n > 0 && runs_[n - 1].length <= runs_[n].length + runs_[n + 1].length)
+							|| (n > 1 && runs_[n - 2].length <= runs_[n - 1].length + runs_[n].length))
+						{
+							if (runs_[n - 1].length < runs_[n + 1].length)
+								--n;
+						}
+						else if (runs_[n].length > runs_[n + 1].length)
+							break;
+						merge_at(n);
+					}
+				}
+
+				void merge_force_collapse()
+				{
+					while (runs_.size() > 1)
+					{
+						size_t n = runs_.size() - 2;
+						if (n > 0 && runs_[n - 1].length < runs_[n + 1].length)
+							--n;
+						merge_at(n);
+					}
+				}
+
+			private:
+				void merge_at(size_t index)
+				{
+					Iterator begin_1 = runs_[index].begin_it, begin_2 = runs_[index + 1].begin_it;
+					ptrdiff_t length_1 = runs_[index].length, length_2 = runs_[index + 1].length;
+
+					runs_[index].length = length_1 + length_2;
+					runs_.erase(runs_.begin() + (index + 1));
+
+					// the prefix of the first run not greater than the second run's head is in place
+					Iterator first_moved = gallop_from_begin(begin_1, begin_2,
+						[&](const value_type& x) { return !cmp_(*begin_2, x); });
+					length_1 -= first_moved - begin_1;
+					begin_1 = first_moved;
+					if (length_1 == 0)
+						return;
+
+					// as is the suffix of the second run not less than the first run's tail
+					Iterator last_moved = gallop_from_end(begin_2, begin_2 + length_2,
+						[&](const value_type& x) { return cmp_(x, *(begin_2 - 1)); });
+					length_2 = last_moved - begin_2;
+					if (length_2 == 0)
+						return;
+
+					if (length_1 <= length_2)
+						merge_low(begin_1, length_1, begin_2, length_2);
+					else
+						merge_high(begin_1, length_1, begin_2, length_2);
+				}
+
+				// the first run is buffered, the merge goes front to back
+				void merge_low(Iterator begin_1, ptrdiff_t length_1, Iterator begin_2, ptrdiff_t length_2)
+				{
+					buffer_.assign(std::make_move_iterator(begin_1), std::make_move_iterator(begin_1 + length_1));
+
+					buffer_iterator left = buffer_.begin(), left_end = buffer_.end();
+					Iterator right = begin_2, right_end = begin_2 + length_2, dest = begin_1;
+
+					while (left != left_end && right != right_end)
+					{
+						ptrdiff_t left_wins = 0, right_wins = 0;
+						while (left != left_end && right != right_end)
+						{
+							if (cmp_(*right, *left))
+							{
+								*dest++ = std::move(*right++);
+								left_wins = 0;
+								if (++right_wins >= min_gallop_)
+									break;
+							}
+							else
+							{
+								*dest++ = std::move(*left++);
+								right_wins = 0;
+								if (++left_wins >= min_gallop_)
+									break;
+							}
+						}
+
+						while (left != left_end && right != right_end)
+						{
+							buffer_iterator left_stop = gallop_from_begin(left, left_end,
+								[&](const value_type& x) { return !cmp_(*right, x); });
+							left_wins = left_stop - left;
+							dest = std::move(left, left_stop, dest);
+							left = left_stop;
+							if (left == left_end)
+								break;
+
+							Iterator right_stop = gallop_from_begin(right, right_end,
+								[&](const value_type& x) { return cmp_(x, *left); });
+							right_wins = right_stop - right;
+							dest = std::move(right, right_stop, dest);
+							right = right_stop;
+
+							if (min_gallop_ > 1)
+								--min_gallop_;
+							if (left_wins < initial_min_gallop && right_wins < initial_min_gallop)
+							{
+								min_gallop_ += 2;
+								break;
+							}
+						}
+					}
+
+					// the rest of the second run is in place already
+					std::move(left, left_end, dest);
+				}
+
+				// the second run is buffered, the merge goes back to front
+				void merge_high(Iterator begin_1, ptrdiff_t length_1, Iterator begin_2, ptrdiff_t length_2)
+				{
+					buffer_.assign(std::make_move_iterator(begin_2), std::make_move_iterator(begin_2 + length_2));
+
+					buffer_iterator right = buffer_.begin(), right_end = buffer_.end();
+					Iterator left = begin_1, left_end = begin_1 + length_1, dest = begin_2 + length_2;
+
+					while (left != left_end && right != right_end)
+					{
+						ptrdiff_t left_wins = 0, right_wins = 0;
+						while (left != left_end && right != right_end)
+						{
+							if (cmp_(*(right_end - 1), *(left_end - 1)))
+							{
+								*--dest = std::move(*--left_end);
+								right_wins = 0;
+								if (++left_wins >= min_gallop_)
+									break;
+							}
+							else
+							{
+								*--dest = std::move(*--right_end);
+								left_wins = 0;
+								if (++right_wins >= min_gallop_)
+									break;
+							}
+						}
+
+						while (left != left_end && right != right_end)
+						{
+							Iterator left_stop = gallop_from_end(left, left_end,
+								[&](const value_type& x) { return !cmp_(*(right_end - 1), x); });
+							left_wins = left_end - left_stop;
+							dest = std::move_backward(left_stop, left_end, dest);
+							left_end = left_stop;
+							if (left == left_end)
+								break;
+
+							buffer_iterator right_stop = gallop_from_end(right, right_end,
+								[&](const value_type& x) { return cmp_(x, *(left_end - 1)); });
+							right_wins = right_end - right_stop;
+							dest = std::move_backward(right_stop, right_end, dest);
+							right_end = right_stop;
+
+							if (min_gallop_ > 1)
+								--min_gallop_;
+							if (left_wins < initial_min_gallop && right_wins < initial_min_gallop)
+							{
+								min_gallop_ += 2;
+								break;
+							}
+						}
+					}
+
+					std::move_backward(right, right_end, dest);
+				}
+
+				Comparator& cmp_;
+				std::vector<value_type> buffer_;
+				std::vector<run> runs_;
+				ptrdiff_t min_gallop_ = initial_min_gallop;
+			};
+
+			// equal ints can't be told apart, so the unstable network keeps the sort stable
+			template<typename Iterator, typename Comparator>
+			inline constexpr bool network_leaf =
+				network::is_network_sortable<Iterator, Comparator> && std::same_as<iter_value<Iterator>, int>;
+
+			template<typename Iterator, typename Comparator>
+			void tim_sort(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				const ptrdiff_t size = end_it - begin_it;
+				if (size < 2)
+					return;
+
+				if (size < min_merge)
+				{
+					if constexpr (network_leaf<Iterator, Comparator>)
+					{
+						network::sort(std::to_address(begin_it), static_cast<size_t>(size));
+						return;
+					}
+					binary_insertion_sort(begin_it, begin_it + count_run(begin_it, end_it, cmp), end_it, cmp);
+					return;
+				}
+
+				merge_state<Iterator, Comparator> state(size, cmp);
+				const ptrdiff_t min_run = min_run_length(size);
+
+				for (Iterator run_begin = begin_it; run_begin != end_it;)
+				{
+					ptrdiff_t run_length = count_run(run_begin, end_it, cmp);
+					if (run_length < min_run)
+					{
+						const ptrdiff_t forced = std::min(min_run, end_it - run_begin);
+						if constexpr (network_leaf<Iterator, Comparator>)
+							network::sort(std::to_address(run_begin), static_cast<size_t>(forced));
+						else
+							binary_insertion_sort(run_begin, run_begin + run_length, run_begin + forced, cmp);
+						run_length = forced;
+					}
+
+					state.push_run(run_begin, run_length);
+					state.merge_collapse();
+					run_begin += run_length;
+				}
+
+				state.merge_force_collapse();
+			}
+		}
+	}
+
+
+	// Stable, O(n log n) worst case, O(n) on presorted runs. Non random access ranges
+	// are moved into a vector and back.
+	template <std::bidirectional_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void MergeSort(Iterator begin_it, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{})
+	{
+		if constexpr (std::random_access_iterator<Iterator>)
+			detail::merge::tim_sort(begin_it, end_it, cmp);
+		else
+		{
+			std::vector<iter_value<Iterator>> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+			detail::merge::tim_sort(buffer.begin(), buffer.end(), cmp);
+			std::move(buffer.begin(), buffer.end(), begin_it);
+		}
+	}
+}
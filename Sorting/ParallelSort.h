@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SortTraits.h"
+#include "PdqSort.h"
+#include "MergeSort.h"
+
+
+namespace sorting
+{
+	struct parallel_options
+	{
+		// threads used at most, the calling one included
+		size_t thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+		// ranges shorter than this are not split between threads
+		size_t grain_size = size_t(1) << 14;
+	};
+
+	namespace detail
+	{
+		namespace parallel
+		{
+			// Runs task(0) ... task(count - 1) on up to thread_count threads, the calling one
+			// included. Tasks are taken from a shared counter, so uneven tasks balance themselves.
+			// The first exception thrown by a task is rethrown after every thread has finished.
+			template<typename Task>
+			void for_each_task(size_t count, size_t thread_count, Task task)
+			{
+				std::atomic<size_t> next = 0;
+				auto worker = [&]()
+				{
+					for (size_t i = next++; i < count; i = next++)
+						task(i);
+				};
+
+				std::vector<std::future<void>> workers;
+				const size_t helpers = std::min(thread_count, count) - 1;
+				workers.reserve(helpers);
+				for (size_t i = 0; i < helpers; ++i)
+					workers.push_back(std::async(std::launch::async, worker));
+
+				std::exception_ptr error;
+				try { worker(); }
+				catch (...) { error = std::current_exception(); }
+
+				for (auto& future : workers)
+				{
+					try { future.get(); }
+					catch (...) { if (!error) error = std::current_exception(); }
+				}
+				if (error)
+					std::rethrow_exception(error);
+			}
+
+			// runs both on two threads, left on a new one
+			template<typename Left, typename Right>
+			void fork_join(Left left, Right right)
+			{
+				auto future = std::async(std::launch::async, left);
+				right();
+				future.get();
+			}
+
+			// Stable merge of two sorted ranges moved into out. Long merges are split at the
+			// middle of the longer input and its position in the shorter one.
+			template<typename Iterator, typename OutIterator, typename Comparator>
+			void merge_ranges(Iterator first_1, Iterator last_1, Iterator first_2, Iterator last_2,
+				OutIterator out, Comparator& cmp, size_t thread_count, size_t grain_size)
+			{
+				const ptrdiff_t length_1 = last_1 - first_1, length_2 = last_2 - first_2;
+				if (thread_count < 2 || static_cast<size_t>(length_1 + length_2) <= grain_size)
+				{
+					std::merge(std::make_move_iterator(first_1), std::make_move_iterator(last_1),
+						std::make_move_iterator(first_2), std::make_move_iterator(last_2), out, cmp);
+					return;
+				}
+
+				Iterator middle_1, middle_2;
+				if (length_1 >= length_2)
+				{
+					middle_1 = first_1 + length_1 / 2;
+					middle_2 = std::lower_bound(first_2, last_2, *middle_1, cmp);
+				}
+				else
+				{
+					middle_2 = first_2 + length_2 / 2;
+					middle_1 = std::upper_bound(first_1, last_1, *middle_2, cmp);
+				}
+
+				OutIterator out_middle = out + ((middle_1 - first_1) + (middle_2 - first_2));
+				const size_t left_threads = thread_count / 2;
+				fork_join(
+					[&]() { merge_ranges(first_1, middle_1, first_2, middle_2, out, cmp, left_threads, grain_size); },
+					[&]() { merge_ranges(middle_1, last_1, middle_2, last_2, out_middle, cmp, thread_count - left_threads, grain_size); });
+			}
+
+			// Sorts [first, last) and leaves the result there or, with into_other, in the
+			// range of the same length starting at other. Halves are sorted into the storage
+			// the result does not go to, so every level costs one merge pass.
+			template<typename Iterator, typename OtherIterator, typename Comparator>
+			void merge_sort(Iterator first, Iterator last, OtherIterator other, bool into_other,
+				Comparator& cmp, size_t thread_count, size_t grain_size)
+			{
+				const ptrdiff_t length = last - first;
+				if (thread_count < 2 || static_cast<size_t>(length) <= grain_size)
+				{
+					detail::merge::tim_sort(first, last, cmp);
+					if (into_other)
+						std::move(first, last, other);
+					return;
+				}
+
+				const ptrdiff_t half = length / 2;
+				Iterator middle = first + half;
+				OtherIterator other_middle = other + half, other_last = other + length;
+				const size_t left_threads = thread_count / 2;
+
+				fork_join(
+					[&]() { merge_sort(first, middle, other, !into_other, cmp, left_threads, grain_size); },
+					[&]() { merge_sort(middle, last, other_middle, !into_other, cmp, thread_count - left_threads, grain_size); });
+
+				if (into_other)
+					merge_ranges(first, middle, middle, last, other, cmp, thread_count, grain_size);
+				else
+					merge_ranges(other, other_middle, other_middle, other_last, first, cmp, thread_count, grain_size);
+			}
+		}
+	}
+
+
+	// Stable. The range is moved into a buffer of the same size once, halves are
+	// sorted and merged in parallel back and forth between the buffer and the range.
+	template<std::random_access_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void ParallelMergeSort(Iterator begin_it, Iterator end_it,
+		Comparator cmp = std::less<iter_value<Iterator>>{}, parallel_options options = {})
+	{
+		const auto size = static_cast<size_t>(end_it - begin_it);
+		if (options.thread_count < 2 || size <= options.grain_size)
+		{
+			MergeSort(begin_it, end_it, cmp);
+			return;
+		}
+
+		std::vector<iter_value<Iterator>> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+		detail::parallel::merge_sort(buffer.begin(), buffer.end(), begin_it, true,
+			cmp, options.thread_count, options.grain_size);
+	}
+
+	// Unstable. Splitters are taken from a sorted random sample, every thread
+	// classifies its chunk, elements are scattered into their buckets and the
+	// buckets are sorted with PdqSort independently.
+	template<std::random_access_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void ParallelSampleSort(Iterator begin_it, Iterator end_it,
+		Comparator cmp = std::less<iter_value<Iterator>>{}, parallel_options options = {})
+	{
+		using value_type = iter_value<Iterator>;
+		constexpr size_t oversampling = 32;
+		constexpr size_t max_buckets = 256;
+
+		const auto size = static_cast<size_t>(end_it - begin_it);
+		if (options.thread_count < 2 || size <= options.grain_size)
+		{
+			PdqSort(begin_it, end_it, cmp);
+			return;
+		}
+
+		// a few buckets per thread keep the load even when the splitters are off
+		const size_t bucket_count = std::min({ max_buckets, options.thread_count * 4, size / options.grain_size + 1 });
+		if (bucket_count < 2)
+		{
+			PdqSort(begin_it, end_it, cmp);
+			return;
+		}
+
+		std::vector<value_type> sample;
+		sample.reserve(bucket_count * oversampling);
+		std::mt19937_64 random(size);
+		std::uniform_int_distribution<size_t> position(0, size - 1);
+		for (size_t i = 0; i < bucket_count * oversampling; ++i)
+			sample.push_back(begin_it[position(random)]);
+		PdqSort(sample.begin(), sample.end(), cmp);
+
+		std::vector<value_type> splitters;
+		splitters.reserve(bucket_count - 1);
+		for (size_t i = 1; i < bucket_count; ++i)
+			splitters.push_back(std::move(sample[i * oversampling]));
+
+		const size_t chunk_count = std::min(options.thread_count, size / options.grain_size + 1);
+		const size_t chunk_size = (size + chunk_count - 1) / chunk_count;
+		std::vector<std::uint8_t> buckets(size);
+		// counts[chunk * bucket_count + bucket], turned into write positions later
+		std::vector<size_t> counts(chunk_count * bucket_count, 0);
+
+		detail::parallel::for_each_task(chunk_count, options.thread_count, [&](size_t chunk)
+			{
+				const size_t first = chunk * chunk_size, last = std::min(size, first + chunk_size);
+				size_t* chunk_counts = counts.data() + chunk * bucket_count;
+				for (size_t i = first; i < last; ++i)
+				{
+					const auto bucket = std::upper_bound(splitters.begin(), splitters.end(), begin_it[i], cmp) - splitters.begin();
+					buckets[i] = static_cast<std::uint8_t>(bucket);
+					++chunk_counts[bucket];
+				}
+			});
+
+		// bucket b of chunk c starts after buckets < b of every chunk and bucket b of chunks < c
+		std::vector<size_t> bucket_begin(bucket_count + 1, 0);
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+		{
+			bucket_begin[bucket] = offset;
+			for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+				offset += std::exchange(counts[chunk * bucket_count + bucket], offset);
+		}
+		bucket_begin[bucket_count] = size;
+
+		std::vector<value_type> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+
+		detail::parallel::for_each_task(chunk_count, options.thread_count, [&](size_t chunk)
+			{
+				const size_t first = chunk * chunk_size, last = std::min(size, first + chunk_size);
+				size_t* chunk_positions = counts.data() + chunk * bucket_count;
+				for (size_t i = first; i < last; ++i)
+					begin_it[chunk_positions[buckets[i]]++] = std::move(buffer[i]);
+			});
+
+		detail::parallel::for_each_task(bucket_count, options.thread_count, [&](size_t bucket)
+			{
+				PdqSort(begin_it + bucket_begin[bucket], begin_it + bucket_begin[bucket + 1], cmp);
+			});
+	}
+}
@@ -0,0 +1,398 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "SortTraits.h"
+#include "SortingNetworks.h"
+
+
+namespace sorting
+{
+	namespace detail
+	{
+		// Pattern-defeating quicksort (Orson Peters): introsort with ninther pivots,
+		// block partitioning for branch-free comparisons, detection of already
+		// partitioned ranges and pattern breaking shuffles on bad partitions.
+		namespace pdq
+		{
+			inline constexpr ptrdiff_t insertion_sort_threshold = 24;
+			inline constexpr ptrdiff_t ninther_threshold = 128;
+			inline constexpr ptrdiff_t partial_insertion_sort_limit = 8;
+			inline constexpr ptrdiff_t block_size = 64;
+
+			template<typename T, typename Comparator>
+			inline constexpr bool is_branchless =
+				std::is_arithmetic_v<T>
+				&& (std::is_same_v<Comparator, std::less<T>> || std::is_same_v<Comparator, std::greater<T>>
+					|| std::is_same_v<Comparator, std::less<>> || std::is_same_v<Comparator, std::greater<>>);
+
+			template<typename Iterator, typename Comparator>
+			void insertion_sort(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				if (begin_it == end_it)
+					return;
+
+				for (Iterator current = begin_it + 1; current != end_it; ++current)
+				{
+					Iterator sift = current, sift_1 = current - 1;
+					if (cmp(*sift, *sift_1))
+					{
+						iter_value<Iterator> tmp = std::move(*sift);
+						do
+						{
+							*sift-- = std::move(*sift_1);
+						} while (sift != begin_it && cmp(tmp, *--sift_1));
+						*sift = std::move(tmp);
+					}
+				}
+			}
+
+			// *(begin_it - 1) is not greater than any element of the range, so it stops the sift
+			template<typename Iterator, typename Comparator>
+			void unguarded_insertion_sort(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				if (begin_it == end_it)
+					return;
+
+				for (Iterator current = begin_it + 1; current != end_it; ++current)
+				{
+					Iterator sift = current, sift_1 = current - 1;
+					if (cmp(*sift, *sift_1))
+					{
+						iter_value<Iterator> tmp = std::move(*sift);
+						do
+						{
+							*sift-- = std::move(*sift_1);
+						} while (cmp(tmp, *--sift_1));
+						*sift = std::move(tmp);
+					}
+				}
+			}
+
+			// gives up after partial_insertion_sort_limit moved elements, returns whether the range got sorted
+			template<typename Iterator, typename Comparator>
+			bool partial_insertion_sort(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				if (begin_it == end_it)
+					return true;
+
+				ptrdiff_t limit = 0;
+				for (Iterator current = begin_it + 1; current != end_it; ++current)
+				{
+					Iterator sift = current, sift_1 = current - 1;
+					if (cmp(*sift, *sift_1))
+					{
+						iter_value<Iterator> tmp = std::move(*sift);
+						do
+						{
+							*sift-- = std::move(*sift_1);
+						} while (sift != begin_it && cmp(tmp, *--sift_1));
+						*sift = std::move(tmp);
+						limit += current - sift;
+					}
+					if (limit > partial_insertion_sort_limit)
+						return false;
+				}
+				return true;
+			}
+
+			template<typename Iterator, typename Comparator>
+			void sort2(Iterator a, Iterator b, Comparator& cmp)
+			{
+				if (cmp(*b, *a))
+					std::iter_swap(a, b);
+			}
+
+			template<typename Iterator, typename Comparator>
+			void sort3(Iterator a, Iterator b, Iterator c, Comparator& cmp)
+			{
+				sort2(a, b, cmp);
+				sort2(b, c, cmp);
+				sort2(a, b, cmp);
+			}
+
+			template<typename Iterator>
+			void swap_offsets(Iterator first, Iterator last,
+				const unsigned char* offsets_l, const unsigned char* offsets_r, size_t count, bool use_swaps)
+			{
+				if (use_swaps)
+				{
+					// equal block counts need a real swap to keep the elements between them in place
+					for (size_t i = 0; i < count; ++i)
+						std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+				}
+				else if (count > 0)
+				{
+					// a cyclic permutation does one move per element instead of three
+					Iterator l = first + offsets_l[0], r = last - offsets_r[0];
+					iter_value<Iterator> tmp(std::move(*l));
+					*l = std::move(*r);
+					for (size_t i = 1; i < count; ++i)
+					{
+						l = first + offsets_l[i];
+						*r = std::move(*l);
+						r = last - offsets_r[i];
+						*l = std::move(*r);
+					}
+					*r = std::move(tmp);
+				}
+			}
+
+			// Partitions around *begin_it: elements equal to the pivot go right.
+			// Returns the pivot position and whether nothing had to be swapped.
+			template<bool Branchless, typename Iterator, typename Comparator>
+			std::pair<Iterator, bool> partition_right(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				iter_value<Iterator> pivot(std::move(*begin_it));
+				Iterator first = begin_it, last = end_it;
+
+				// the median of 3 guarantees an element not less than the pivot on the right
+				while (cmp(*++first, pivot));
+
+				if (first - 1 == begin_it)
+					while (first < last && !cmp(*--last, pivot));
+				else
+					while (!cmp(*--last, pivot));
+
+				const bool already_partitioned = first >= last;
+
+				if constexpr (Branchless)
+				{
+					if (!already_partitioned)
+					{
+						std::iter_swap(first, last);
+						++first;
+
+						// comparison results are written as offsets, the swaps happen in bulk,
+						// so there is no data dependent branch in the hot loops
+						unsigned char offsets_l[block_size];
+						unsigned char offsets_r[block_size];
+						Iterator offsets_l_base = first, offsets_r_base = last;
+						size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+						while (first < last)
+						{
+							const size_t num_unknown = last - first;
+							const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+							const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+							const size_t left_count = std::min<size_t>(left_split, block_size);
+							for (size_t i = 0; i < left_count; ++i)
+							{
+								offsets_l[num_l] = static_cast<unsigned char>(i);
+								num_l += !cmp(*first, pivot);
+								++first;
+							}
+
+							const size_t right_count = std::min<size_t>(right_split, block_size);
+							for (size_t i = 0; i < right_count;)
+							{
+								offsets_r[num_r] = static_cast<unsigned char>(++i);
+								num_r += cmp(*--last, pivot);
+							}
+
+							const size_t count = std::min(num_l, num_r);
+							swap_offsets(offsets_l_base, offsets_r_base,
+								offsets_l + start_l, offsets_r + start_r, count, num_l == num_r);
+							num_l -= count;
+							num_r -= count;
+							start_l += count;
+							start_r += count;
+
+							if (num_l == 0)
+							{
+								start_l = 0;
+								offsets_l_base = first;
+							}
+							if (num_r == 0)
+							{
+								start_r = 0;
+								offsets_r_base = last;
+							}
+						}
+
+						// one of the blocks may still hold misplaced elements
+						if (num_l != 0)
+						{
+							while (num_l--)
+								std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+							first = last;
+						}
+						if (num_r != 0)
+						{
+							while (num_r--)
+							{
+								std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+								++first;
+							}
+							last = first;
+						}
+					}
+				}
+				else
+				{
+					while (first < last)
+					{
+						std::iter_swap(first, last);
+						while (cmp(*++first, pivot));
+						while (!cmp(*--last, pivot));
+					}
+				}
+
+				Iterator pivot_position = first - 1;
+				*begin_it = std::move(*pivot_position);
+				*pivot_position = std::move(pivot);
+				return { pivot_position, already_partitioned };
+			}
+
+			// Partitions around *begin_it with equal elements going left. Used when the pivot
+			// equals the element before the range, then the left part is all equal and done.
+			template<typename Iterator, typename Comparator>
+			Iterator partition_left(Iterator begin_it, Iterator end_it, Comparator& cmp)
+			{
+				iter_value<Iterator> pivot(std::move(*begin_it));
+				Iterator first = begin_it, last = end_it;
+
+				while (cmp(pivot, *--last));
+
+				if (last + 1 == end_it)
+					while (first < last && !cmp(pivot, *++first));
+				else
+					while (!cmp(pivot, *++first));
+
+				while (first < last)
+				{
+					std::iter_swap(first, last);
+					while (cmp(pivot, *--last));
+					while (!cmp(pivot, *++first));
+				}
+
+				Iterator pivot_position = last;
+				*begin_it = std::move(*pivot_position);
+				*pivot_position = std::move(pivot);
+				return pivot_position;
+			}
+
+			// bad_allowed bounds the number of unbalanced partitions before falling back to heapsort
+			template<bool Branchless, typename Iterator, typename Comparator>
+			void pdqsort_loop(Iterator begin_it, Iterator end_it, Comparator& cmp, int bad_allowed, bool leftmost = true)
+			{
+				while (true)
+				{
+					const ptrdiff_t size = end_it - begin_it;
+
+					if constexpr (network::is_network_sortable<Iterator, Comparator>)
+					{
+						if (size <= static_cast<ptrdiff_t>(network_max_size))
+						{
+							network::sort(std::to_address(begin_it), static_cast<size_t>(size));
+							return;
+						}
+					}
+					else if (size < insertion_sort_threshold)
+					{
+						if (leftmost)
+							insertion_sort(begin_it, end_it, cmp);
+						else
+							unguarded_insertion_sort(begin_it, end_it, cmp);
+						return;
+					}
+
+					// the pivot ends up in *begin_it
+					const ptrdiff_t half = size / 2;
+					if (size > ninther_threshold)
+					{
+						sort3(begin_it, begin_it + half, end_it - 1, cmp);
+						sort3(begin_it + 1, begin_it + (half - 1), end_it - 2, cmp);
+						sort3(begin_it + 2, begin_it + (half + 1), end_it - 3, cmp);
+						sort3(begin_it + (half - 1), begin_it + half, begin_it + (half + 1), cmp);
+						std::iter_swap(begin_it, begin_it + half);
+					}
+					else
+						sort3(begin_it + half, begin_it, end_it - 1, cmp);
+
+					// many equal elements: everything equal to the pivot is already in place
+					if (!leftmost && !cmp(*(begin_it - 1), *begin_it))
+					{
+						begin_it = partition_left(begin_it, end_it, cmp) + 1;
+						continue;
+					}
+
+					auto [pivot_position, already_partitioned] = partition_right<Branchless>(begin_it, end_it, cmp);
+
+					const ptrdiff_t l_size = pivot_position - begin_it;
+					const ptrdiff_t r_size = end_it - (pivot_position + 1);
+					const bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+					if (highly_unbalanced)
+					{
+						if (--bad_allowed == 0)
+						{
+							std::make_heap(begin_it, end_it, cmp);
+							std::sort_heap(begin_it, end_it, cmp);
+							return;
+						}
+
+						// shuffle a few elements to break the pattern that caused the bad pivot
+						if (l_size >= insertion_sort_threshold)
+						{
+							std::iter_swap(begin_it, begin_it + l_size / 4);
+							std::iter_swap(pivot_position - 1, pivot_position - l_size / 4);
+							if (l_size > ninther_threshold)
+							{
+								std::iter_swap(begin_it + 1, begin_it + (l_size / 4 + 1));
+								std::iter_swap(begin_it + 2, begin_it + (l_size / 4 + 2));
+								std::iter_swap(pivot_position - 2, pivot_position - (l_size / 4 + 1));
+								std::iter_swap(pivot_position - 3, pivot_position - (l_size / 4 + 2));
+							}
+						}
+						if (r_size >= insertion_sort_threshold)
+						{
+							std::iter_swap(pivot_position + 1, pivot_position + (1 + r_size / 4));
+							std::iter_swap(end_it - 1, end_it - r_size / 4);
+							if (r_size > ninther_threshold)
+							{
+								std::iter_swap(pivot_position + 2, pivot_position + (2 + r_size / 4));
+								std::iter_swap(pivot_position + 3, pivot_position + (3 + r_size / 4));
+								std::iter_swap(end_it - 2, end_it - (1 + r_size / 4));
+								std::iter_swap(end_it - 3, end_it - (2 + r_size / 4));
+							}
+						}
+					}
+					else if (already_partitioned
+						&& partial_insertion_sort(begin_it, pivot_position, cmp)
+						&& partial_insertion_sort(pivot_position + 1, end_it, cmp))
+					{
+						// the range was (almost) sorted
+						return;
+					}
+
+					// recursion on the left part, the loop continues with the right one
+					pdqsort_loop<Branchless>(begin_it, pivot_position, cmp, bad_allowed, leftmost);
+					begin_it = pivot_position + 1;
+					leftmost = false;
+				}
+			}
+		}
+	}
+
+
+	// Unstable, O(n log n) worst case, O(n) on sorted, reversed and equal ranges
+	template<std::random_access_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void PdqSort(Iterator begin_it, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{})
+	{
+		const auto size = end_it - begin_it;
+		if (size < 2)
+			return;
+
+		constexpr bool branchless = detail::pdq::is_branchless<iter_value<Iterator>, Comparator>;
+		detail::pdq::pdqsort_loop<branchless>(begin_it, end_it, cmp,
+			static_cast<int>(std::bit_width(static_cast<size_t>(size))));
+	}
+}
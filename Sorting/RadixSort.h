@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SortTraits.h"
+#include "PdqSort.h"
+#include "MergeSort.h"
+
+
+namespace sorting
+{
+	namespace detail
+	{
+		namespace radix
+		{
+			template<typename T>
+			struct is_pair : std::false_type {};
+
+			template<typename First, typename Second>
+			struct is_pair<std::pair<First, Second>> : std::true_type {};
+
+			template<typename Key>
+			concept scalar_key =
+				(std::integral<Key> && !std::same_as<Key, bool>)
+				|| (std::floating_point<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8));
+
+			// keys that map to one unsigned integer with the same order, pairs compare lexicographically
+			template<typename Key>
+			concept lsd_key = scalar_key<Key>
+				|| (is_pair<Key>::value
+					&& scalar_key<typename Key::first_type> && scalar_key<typename Key::second_type>
+					&& sizeof(typename Key::first_type) + sizeof(typename Key::second_type) <= 8);
+
+			template<typename Key>
+			concept msd_key = !lsd_key<std::remove_cvref_t<Key>> && std::convertible_to<Key, std::string_view>;
+
+			template<typename Key>
+			concept radix_key = lsd_key<std::remove_cvref_t<Key>> || msd_key<Key>;
+
+			template<std::size_t Bytes>
+			using unsigned_of = std::conditional_t<Bytes <= 1, std::uint8_t,
+				std::conditional_t<Bytes <= 2, std::uint16_t,
+				std::conditional_t<Bytes <= 4, std::uint32_t, std::uint64_t>>>;
+
+			// Signed integers get the sign bit flipped, negative floats all bits and positive
+			// floats the sign bit, so unsigned order matches the order of the keys.
+			template<typename Key>
+			constexpr auto ordered_bits(const Key& key) noexcept
+			{
+				if constexpr (is_pair<Key>::value)
+				{
+					using bits_type = unsigned_of<sizeof(typename Key::first_type) + sizeof(typename Key::second_type)>;
+					constexpr int shift = 8 * sizeof(typename Key::second_type);
+					return static_cast<bits_type>(static_cast<bits_type>(ordered_bits(key.first)) << shift
+						| static_cast<bits_type>(ordered_bits(key.second)));
+				}
+				else if constexpr (std::floating_point<Key>)
+				{
+					using bits_type = unsigned_of<sizeof(Key)>;
+					constexpr bits_type sign = bits_type(1) << (8 * sizeof(Key) - 1);
+					const auto bits = std::bit_cast<bits_type>(key);
+					return static_cast<bits_type>((bits & sign) ? ~bits : (bits | sign));
+				}
+				else
+				{
+					using bits_type = std::make_unsigned_t<Key>;
+					if constexpr (std::is_signed_v<Key>)
+						return static_cast<bits_type>(static_cast<bits_type>(key) ^ (bits_type(1) << (8 * sizeof(Key) - 1)));
+					else
+						return static_cast<bits_type>(key);
+				}
+			}
+
+			inline constexpr ptrdiff_t lsd_threshold = 64;
+			inline constexpr ptrdiff_t msd_threshold = 32;
+
+			template<typename InIterator, typename OutIterator, typename BitsOf>
+			void scatter(InIterator first, InIterator last, OutIterator out,
+				std::array<size_t, 256>& positions, int shift, BitsOf& bits_of)
+			{
+				for (; first != last; ++first)
+				{
+					const auto digit = static_cast<size_t>((bits_of(*first) >> shift) & 0xFF);
+					out[positions[digit]++] = std::move(*first);
+				}
+			}
+
+			// Stable LSD sort by bytes. One pass counts every byte, bytes equal for all
+			// keys are skipped, the rest ping-pong between the range and one buffer.
+			template<typename Iterator, typename KeyExtractor>
+			void lsd_sort(Iterator first, Iterator last, KeyExtractor& key)
+			{
+				using value_type = iter_value<Iterator>;
+				auto bits_of = [&](const value_type& value) { return ordered_bits(std::invoke(key, value)); };
+				using bits_type = std::invoke_result_t<decltype(bits_of)&, const value_type&>;
+				constexpr size_t digits = sizeof(bits_type);
+
+				const ptrdiff_t size = last - first;
+				if (size < lsd_threshold)
+				{
+					MergeSort(first, last, [&](const value_type& left, const value_type& right)
+						{ return bits_of(left) < bits_of(right); });
+					return;
+				}
+
+				std::array<std::array<size_t, 256>, digits> counts{};
+				for (Iterator it = first; it != last; ++it)
+				{
+					const bits_type bits = bits_of(*it);
+					for (size_t digit = 0; digit < digits; ++digit)
+						++counts[digit][(bits >> (8 * digit)) & 0xFF];
+				}
+
+				std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+				bool in_buffer = true;
+
+				for (size_t digit = 0; digit < digits; ++digit)
+				{
+					auto& positions = counts[digit];
+					if (std::ranges::find(positions, static_cast<size_t>(size)) != positions.end())
+						continue;
+
+					size_t offset = 0;
+					for (auto& position : positions)
+						offset += std::exchange(position, offset);
+
+					const int shift = static_cast<int>(8 * digit);
+					if (in_buffer)
+						scatter(buffer.begin(), buffer.end(), first, positions, shift, bits_of);
+					else
+						scatter(first, last, buffer.begin(), positions, shift, bits_of);
+					in_buffer = !in_buffer;
+				}
+
+				if (in_buffer)
+					std::move(buffer.begin(), buffer.end(), first);
+			}
+
+			// 0 for strings ending before depth, 1 + the byte otherwise
+			inline size_t digit_at(std::string_view key, size_t depth) noexcept
+			{
+				return depth < key.size() ? 1 + static_cast<unsigned char>(key[depth]) : 0;
+			}
+
+			// In place MSD sort (American flag): every range is split into 257 buckets by the byte
+			// at depth, elements are cycled into their buckets and buckets continue one byte deeper.
+			// Ranges wait on an explicit stack, so long common prefixes can't overflow the call stack.
+			template<typename Iterator, typename KeyExtractor>
+			void msd_sort(Iterator first, Iterator last, KeyExtractor& key)
+			{
+				using value_type = iter_value<Iterator>;
+				constexpr size_t buckets = 257;
+
+				struct task
+				{
+					Iterator first, last;
+					size_t depth;
+				};
+				std::vector<task> tasks{ { first, last, 0 } };
+
+				while (!tasks.empty())
+				{
+					const auto [begin_it, end_it, depth] = tasks.back();
+					tasks.pop_back();
+					const ptrdiff_t size = end_it - begin_it;
+
+					// every key in the range shares its first depth bytes
+					if (size < msd_threshold)
+					{
+						PdqSort(begin_it, end_it, [&](const value_type& left, const value_type& right)
+							{ return std::string_view(std::invoke(key, left)).substr(depth) < std::string_view(std::invoke(key, right)).substr(depth); });
+						continue;
+					}
+
+					std::array<ptrdiff_t, buckets> counts{};
+					for (Iterator it = begin_it; it != end_it; ++it)
+						++counts[digit_at(std::invoke(key, *it), depth)];
+
+					if (counts[0] == size)
+						continue;
+					if (std::ranges::find(counts, size) != counts.end())
+					{
+						tasks.push_back({ begin_it, end_it, depth + 1 });
+						continue;
+					}
+
+					std::array<ptrdiff_t, buckets + 1> bucket_begin{};
+					for (size_t bucket = 0; bucket < buckets; ++bucket)
+						bucket_begin[bucket + 1] = bucket_begin[bucket] + counts[bucket];
+
+					std::array<ptrdiff_t, buckets> next{};
+					std::copy_n(bucket_begin.begin(), buckets, next.begin());
+
+					// buckets before the current one are complete, so a cycle always ends in it
+					for (size_t bucket = 0; bucket < buckets; ++bucket)
+					{
+						while (next[bucket] < bucket_begin[bucket + 1])
+						{
+							value_type moved = std::move(begin_it[next[bucket]]);
+							for (size_t digit = digit_at(std::invoke(key, moved), depth); digit != bucket; digit = digit_at(std::invoke(key, moved), depth))
+								std::swap(moved, begin_it[next[digit]++]);
+							begin_it[next[bucket]++] = std::move(moved);
+						}
+					}
+
+					for (size_t bucket = 1; bucket < buckets; ++bucket)
+					{
+						if (counts[bucket] > 1)
+							tasks.push_back({ begin_it + bucket_begin[bucket], begin_it + bucket_begin[bucket + 1], depth + 1 });
+					}
+				}
+			}
+		}
+	}
+
+
+	// Ascending by std::invoke(key, value). Integral, floating point keys and pairs of them are sorted
+	// by stable LSD passes, keys convertible to std::string_view by unstable in place MSD.
+	// Non random access ranges are moved into a vector and back.
+	template<std::bidirectional_iterator Iterator, typename KeyExtractor>
+	requires detail::radix::radix_key<std::invoke_result_t<KeyExtractor&, const iter_value<Iterator>&>>
+	void RadixSort(Iterator begin_it, Iterator end_it, KeyExtractor key)
+	{
+		using key_type = std::invoke_result_t<KeyExtractor&, const iter_value<Iterator>&>;
+
+		if constexpr (!std::random_access_iterator<Iterator>)
+		{
+			std::vector<iter_value<Iterator>> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+			RadixSort(buffer.begin(), buffer.end(), std::move(key));
+			std::move(buffer.begin(), buffer.end(), begin_it);
+		}
+		else if constexpr (detail::radix::lsd_key<std::remove_cvref_t<key_type>>)
+			detail::radix::lsd_sort(begin_it, end_it, key);
+		else
+			detail::radix::msd_sort(begin_it, end_it, key);
+	}
+
+	template<std::bidirectional_iterator Iterator>
+	requires detail::radix::radix_key<const iter_value<Iterator>&>
+	void RadixSort(Iterator begin_it, Iterator end_it)
+	{
+		RadixSort(begin_it, end_it, std::identity{});
+	}
+}
@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "SortTraits.h"
+#include "PdqSort.h"
+
+
+namespace sorting
+{
+	namespace detail
+	{
+		// Introselect: quickselect on the partition of pdqsort, only the side holding nth
+		// is continued. Large ranges take the pivot by Floyd-Rivest sampling, it lands
+		// next to nth, so the range shrinks to a few sqrt(n) elements in one step.
+		// Too many unbalanced partitions switch to heap selection.
+		namespace select
+		{
+			inline constexpr ptrdiff_t insertion_threshold = 16;
+			inline constexpr ptrdiff_t floyd_rivest_threshold = 600;
+
+			// [begin_it, middle) gets the smallest elements as a max heap, the top is the largest of them
+			template<typename Iterator, typename Comparator>
+			void heap_select(Iterator begin_it, Iterator middle, Iterator end_it, Comparator& cmp)
+			{
+				std::make_heap(begin_it, middle, cmp);
+				for (Iterator it = middle; it != end_it; ++it)
+				{
+					if (cmp(*it, *begin_it))
+					{
+						std::pop_heap(begin_it, middle, cmp);
+						std::iter_swap(it, middle - 1);
+						std::push_heap(begin_it, middle, cmp);
+					}
+				}
+			}
+
+			template<typename Iterator, typename Comparator>
+			void nth_element(Iterator begin_it, Iterator nth, Iterator end_it, Comparator& cmp);
+
+			// Puts the pivot into *begin_it and an element not less than it at the end, which
+			// partition_right needs. For Floyd-Rivest the element of rank nth is selected from a
+			// window around nth, so it estimates the element of rank nth of the whole range.
+			// Returns false when the pivot is greater than everything else and went to the end,
+			// then the range is already partitioned.
+			template<typename Iterator, typename Comparator>
+			bool choose_pivot(Iterator begin_it, Iterator nth, Iterator end_it, Comparator& cmp)
+			{
+				const ptrdiff_t size = end_it - begin_it;
+				if (size > floyd_rivest_threshold)
+				{
+					const double n = static_cast<double>(size);
+					const double i = static_cast<double>(nth - begin_it);
+					const double z = std::log(n);
+					const double s = 0.5 * std::exp(2 * z / 3);
+					const double deviation = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+
+					const auto window_begin = std::min(static_cast<ptrdiff_t>(std::max(0.0, i - i * s / n + deviation)), nth - begin_it);
+					const auto window_end = std::max(static_cast<ptrdiff_t>(std::min(n, i + (n - i) * s / n + deviation + 1)), nth - begin_it + 1);
+					select::nth_element(begin_it + window_begin, nth, begin_it + window_end, cmp);
+					std::iter_swap(begin_it, nth);
+
+					// the window put the elements not less than the pivot after nth
+					Iterator guard = begin_it + (window_end - 1);
+					if (guard == nth)
+					{
+						guard = end_it - 1;
+						while (guard != begin_it && cmp(*guard, *begin_it))
+							--guard;
+						if (guard == begin_it)
+						{
+							std::iter_swap(begin_it, end_it - 1);
+							return false;
+						}
+					}
+					std::iter_swap(guard, end_it - 1);
+				}
+				else
+				{
+					const ptrdiff_t half = size / 2;
+					if (size > pdq::ninther_threshold)
+					{
+						pdq::sort3(begin_it, begin_it + half, end_it - 1, cmp);
+						pdq::sort3(begin_it + 1, begin_it + (half - 1), end_it - 2, cmp);
+						pdq::sort3(begin_it + 2, begin_it + (half + 1), end_it - 3, cmp);
+						pdq::sort3(begin_it + (half - 1), begin_it + half, begin_it + (half + 1), cmp);
+						std::iter_swap(begin_it, begin_it + half);
+					}
+					else
+						pdq::sort3(begin_it + half, begin_it, end_it - 1, cmp);
+				}
+				return true;
+			}
+
+			template<typename Iterator, typename Comparator>
+			void nth_element(Iterator begin_it, Iterator nth, Iterator end_it, Comparator& cmp)
+			{
+				constexpr bool branchless = pdq::is_branchless<iter_value<Iterator>, Comparator>;
+				int bad_allowed = static_cast<int>(std::bit_width(static_cast<size_t>(end_it - begin_it)));
+
+				while (end_it - begin_it > insertion_threshold)
+				{
+					const ptrdiff_t size = end_it - begin_it;
+					Iterator pivot_position = choose_pivot(begin_it, nth, end_it, cmp)
+						? pdq::partition_right<branchless>(begin_it, end_it, cmp).first
+						: end_it - 1;
+
+					if (pivot_position == nth)
+						return;
+
+					const ptrdiff_t l_size = pivot_position - begin_it;
+					const ptrdiff_t r_size = end_it - (pivot_position + 1);
+					if ((l_size < size / 8 || r_size < size / 8) && --bad_allowed == 0)
+					{
+						if (nth < pivot_position)
+							end_it = pivot_position;
+						else
+							begin_it = pivot_position + 1;
+						heap_select(begin_it, nth + 1, end_it, cmp);
+						std::iter_swap(begin_it, nth);
+						return;
+					}
+
+					if (nth < pivot_position)
+						end_it = pivot_position;
+					else
+						begin_it = pivot_position + 1;
+				}
+				pdq::insertion_sort(begin_it, end_it, cmp);
+			}
+
+			// non random access ranges are selected in a vector and moved back
+			template<typename Iterator, typename Function>
+			void through_buffer(Iterator begin_it, Iterator end_it, Function function)
+			{
+				std::vector<iter_value<Iterator>> buffer(std::make_move_iterator(begin_it), std::make_move_iterator(end_it));
+				function(buffer.begin(), buffer.end());
+				std::move(buffer.begin(), buffer.end(), begin_it);
+			}
+		}
+	}
+
+
+	// Rearranges the range so that *nth is the element a full sort would put there, no element
+	// before it is greater and no element after it is less. Expected O(n), O(n log n) worst case.
+	template<std::bidirectional_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void NthElement(Iterator begin_it, Iterator nth, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{})
+	{
+		if (nth == end_it)
+			return;
+
+		if constexpr (std::random_access_iterator<Iterator>)
+			detail::select::nth_element(begin_it, nth, end_it, cmp);
+		else
+		{
+			const auto index = std::distance(begin_it, nth);
+			detail::select::through_buffer(begin_it, end_it, [&](auto first, auto last)
+				{ detail::select::nth_element(first, first + index, last, cmp); });
+		}
+	}
+
+	// The smallest middle - begin_it elements go sorted to the front, the rest in no particular
+	// order after them. O(n + k log k) expected for k = middle - begin_it.
+	template<std::bidirectional_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	void PartialSort(Iterator begin_it, Iterator middle, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{})
+	{
+		if (begin_it == middle)
+			return;
+
+		if constexpr (std::random_access_iterator<Iterator>)
+		{
+			if (middle != end_it)
+				detail::select::nth_element(begin_it, middle, end_it, cmp);
+			PdqSort(begin_it, middle, cmp);
+		}
+		else
+		{
+			const auto index = std::distance(begin_it, middle);
+			detail::select::through_buffer(begin_it, end_it, [&](auto first, auto last)
+				{ PartialSort(first, first + index, last, cmp); });
+		}
+	}
+
+
+	// Keeps the k elements that come first in cmp order out of everything pushed, in
+	// O(k) memory and O(log k) per push. The kept elements form a heap with the last
+	// of them on top, a new element replaces it when it comes before it.
+	template<typename T, typename Comparator = std::less<T>>
+	class top_k
+	{
+	public:
+		explicit top_k(size_t k, Comparator cmp = Comparator{})
+			: k_(k), cmp_(std::move(cmp))
+		{
+			heap_.reserve(k);
+		}
+
+		void push(const T& value)
+		{
+			emplace(value);
+		}
+
+		void push(T&& value)
+		{
+			emplace(std::move(value));
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return heap_.size(); }
+		[[nodiscard]] size_t k() const noexcept { return k_; }
+		[[nodiscard]] bool full() const noexcept { return heap_.size() == k_; }
+
+		// the last of the kept elements, new elements have to come before it
+		[[nodiscard]] const T& threshold() const
+		{
+			if (heap_.empty())
+				throw std::out_of_range("in top_k::threshold nothing is kept");
+			return heap_.front();
+		}
+
+		// the kept elements in cmp order, the selector is left empty
+		[[nodiscard]] std::vector<T> extract()
+		{
+			std::sort_heap(heap_.begin(), heap_.end(), cmp_);
+			return std::exchange(heap_, {});
+		}
+
+	private:
+		template<typename U>
+		void emplace(U&& value)
+		{
+			if (heap_.size() < k_)
+			{
+				heap_.push_back(std::forward<U>(value));
+				std::push_heap(heap_.begin(), heap_.end(), cmp_);
+			}
+			else if (k_ > 0 && cmp_(value, heap_.front()))
+			{
+				std::pop_heap(heap_.begin(), heap_.end(), cmp_);
+				heap_.back() = std::forward<U>(value);
+				std::push_heap(heap_.begin(), heap_.end(), cmp_);
+			}
+		}
+
+		size_t k_;
+		Comparator cmp_;
+		std::vector<T> heap_;
+	};
+
+	// The k elements of the range that come first in cmp order, sorted. The range is
+	// only read once, so any input iterator works.
+	template<std::input_iterator Iterator,
+	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
+	std::vector<iter_value<Iterator>> TopK(Iterator begin_it, Iterator end_it, size_t k,
+		Comparator cmp = std::less<iter_value<Iterator>>{})
+	{
+		top_k<iter_value<Iterator>, Comparator> selector(k, std::move(cmp));
+		for (; begin_it != end_it; ++begin_it)
+			selector.push(*begin_it);
+		return selector.extract();
+	}
+}
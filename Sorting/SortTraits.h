@@ -0,0 +1,14 @@
+#pragma once
+#include <concepts>
+#include <functional>
+#include <iterator>
+
+
+namespace sorting
+{
+	template <typename  Iterator>
+	using iter_value = typename std::iterator_traits<Iterator>::value_type;
+
+	template <typename Func, typename  Iterator>
+	concept iter_compare = std::relation<Func, const iter_value<Iterator>&, const iter_value<Iterator>&>;
+}
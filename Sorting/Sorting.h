@@ -1,5 +1,6 @@
 #pragma once
 #include <algorithm>
+#include <bit>
 #include <numeric>
 #include <vector>
 #include <iterator>
@@ -7,57 +8,118 @@
 #include <functional>
 #include <random>
 
+#include "SortTraits.h"
+#include "SortingNetworks.h"
+#include "PdqSort.h"
+#include "MergeSort.h"
+#include "ParallelSort.h"
+#include "RadixSort.h"
+#include "Selection.h"
+#include "ExternalSort.h"
+#include "AdaptiveSort.h"
+
 
 namespace sorting
 {
-	template <typename  Iterator>
-	using iter_value = typename std::iterator_traits<Iterator>::value_type;
-
-	template <typename Func, typename  Iterator>
-	concept iter_compare = std::relation<Func, const iter_value<Iterator>&, const iter_value<Iterator>&>;
-
-
-
-	template <std::bidirectional_iterator RandomIt,
-	iter_compare<RandomIt> Comparator = std::less<iter_value<RandomIt>>>
-	void MergeSort(RandomIt begin_it, RandomIt end_it, Comparator cmp = std::less<iter_value<RandomIt>>{})
-	{
-		using namespace std;
-		const int range_length = distance(begin_it, end_it);
-		if (range_length < 2) {
-			return;
-		}
-
-		auto one_third = next(begin_it, range_length / 3);
-		auto two_third = next(begin_it, range_length * 2 / 3);
-
-		MergeSort(begin_it, one_third);
-		MergeSort(one_third, two_third);
-		MergeSort(two_third, end_it);
-
-		inplace_merge( begin_it, one_third, two_third, cmp); 
-		inplace_merge(begin_it, two_third, end_it, cmp);
-	}
-
-
-
 	template<std::bidirectional_iterator Iterator,
 	iter_compare<Iterator> Comparator = std::less<iter_value<Iterator>>>
 	void QuickSort(Iterator begin_it, Iterator end_it, Comparator cmp = std::less<iter_value<Iterator>>{})
 	{
 		using namespace std;
-		if (distance(begin_it, end_it) > 1)
+		int bad_allowed = static_cast<int>(bit_width(static_cast<size_t>(distance(begin_it, end_it))));
+		while (true)
 		{
-			Iterator pivot = begin_it, middle_it = next(begin_it);
-
-			for (Iterator i = middle_it; i != end_it; ++i) 
-				if (cmp(*i, *pivot)) 
-					iter_swap(i, middle_it++);
-
-			iter_swap(begin_it, prev(middle_it));
-
-			QuickSort(begin_it, prev(middle_it));
-			QuickSort(middle_it, end_it);
+			const auto range_length = distance(begin_it, end_it);
+			if (range_length < 2)
+				return;
+			if constexpr (detail::network::is_network_sortable<Iterator, Comparator>)
+			{
+				if (range_length <= static_cast<ptrdiff_t>(network_max_size))
+				{
+					detail::network::sort(std::to_address(begin_it), static_cast<size_t>(range_length));
+					return;
+				}
+			}
+
+			// median of first, middle and last goes to the front as the pivot
+			Iterator middle = next(begin_it, range_length / 2), last = prev(end_it);
+			if (cmp(*middle, *begin_it))
+				iter_swap(middle, begin_it);
+			if (cmp(*last, *middle))
+			{
+				iter_swap(last, middle);
+				if (cmp(*middle, *begin_it))
+					iter_swap(middle, begin_it);
+			}
+			iter_swap(begin_it, middle);
+
+			// Bentley-McIlroy three way partition of the rest. Keys equal to the pivot are
+			// parked at both ends while scanning, then swapped into the middle, so only the
+			// strictly less and strictly greater parts are sorted further.
+			Iterator pivot = begin_it;
+			Iterator equal_left = next(begin_it), less_end = equal_left;
+			Iterator greater_begin = prev(end_it), equal_right = greater_begin;
+			// positions of less_end and greater_begin, bidirectional iterators can not be compared
+			iter_difference_t<Iterator> less_index = 1, greater_index = range_length - 1;
+			iter_difference_t<Iterator> equal_left_length = 1, equal_right_length = 0;
+
+			while (true)
+			{
+				while (less_index <= greater_index && !cmp(*pivot, *less_end))
+				{
+					if (!cmp(*less_end, *pivot))
+					{
+						iter_swap(equal_left++, less_end);
+						++equal_left_length;
+					}
+					++less_end;
+					++less_index;
+				}
+				while (less_index <= greater_index && !cmp(*greater_begin, *pivot))
+				{
+					if (!cmp(*pivot, *greater_begin))
+					{
+						iter_swap(greater_begin, equal_right--);
+						++equal_right_length;
+					}
+					--greater_begin;
+					--greater_index;
+				}
+				if (less_index > greater_index)
+					break;
+				iter_swap(less_end++, greater_begin--);
+				++less_index;
+				--greater_index;
+			}
+
+			const auto less_length = less_index - equal_left_length;
+			const auto greater_length = range_length - less_index - equal_right_length;
+			const auto left_moved = std::min(equal_left_length, less_length);
+			std::swap_ranges(begin_it, next(begin_it, left_moved), prev(less_end, left_moved));
+			const auto right_moved = std::min(equal_right_length, greater_length);
+			std::swap_ranges(less_end, next(less_end, right_moved), prev(end_it, right_moved));
+
+			Iterator less_last = next(begin_it, less_length), greater_first = prev(end_it, greater_length);
+
+			// too many unbalanced partitions, the rest is merge sorted
+			if (std::min(less_length, greater_length) < range_length / 8 && --bad_allowed == 0)
+			{
+				MergeSort(begin_it, less_last, cmp);
+				MergeSort(greater_first, end_it, cmp);
+				return;
+			}
+
+			// recursion on the smaller part keeps the stack logarithmic
+			if (less_length < greater_length)
+			{
+				QuickSort(begin_it, less_last, cmp);
+				begin_it = greater_first;
+			}
+			else
+			{
+				QuickSort(greater_first, end_it, cmp);
+				end_it = less_last;
+			}
 		}
 	}
 
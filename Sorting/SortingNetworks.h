@@ -0,0 +1,518 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SORTING_NETWORKS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define SORTING_NETWORKS_X86 0
+#endif
+
+// MSVC accepts every intrinsic anywhere, GCC and Clang need the instruction set on the
+// function and flatten to inline the generic network into the per instruction set entry.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SORTING_NETWORKS_TARGET(ISA)
+#define SORTING_NETWORKS_FLATTEN
+#else
+#define SORTING_NETWORKS_TARGET(ISA) __attribute__((target(ISA)))
+#define SORTING_NETWORKS_FLATTEN __attribute__((flatten))
+#endif
+
+
+namespace sorting
+{
+	inline constexpr size_t network_max_size = 64;
+
+	enum class simd_level { scalar, sse41, avx2 };
+
+	inline simd_level detect_simd_level() noexcept
+	{
+#if SORTING_NETWORKS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+		__cpuid(info, 1);
+		const bool sse41 = info[2] & (1 << 19);
+		const bool os_saves_ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		bool avx2 = false;
+		if (max_leaf >= 7 && os_saves_ymm)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = info[1] & (1 << 5);
+		}
+#else
+		__builtin_cpu_init();
+		const bool sse41 = __builtin_cpu_supports("sse4.1");
+		const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		if (avx2)
+			return simd_level::avx2;
+		if (sse41)
+			return simd_level::sse41;
+#endif
+		return simd_level::scalar;
+	}
+
+	namespace detail
+	{
+		// Bitonic sorting networks over blocks of up to network_max_size elements. A block is
+		// padded to registers * lanes, every register is sorted across its lanes, then sorted
+		// groups of registers are merged pairwise: the second group is reversed, a vertical
+		// min/max splits both into bitonic halves and half cleaners finish the merge.
+		namespace network
+		{
+			template<typename T>
+			concept network_value = std::same_as<T, int> || std::same_as<T, float> || std::same_as<T, double>;
+
+			template<typename Iterator, typename Comparator>
+			inline constexpr bool is_network_sortable =
+				std::contiguous_iterator<Iterator>
+				&& network_value<std::iter_value_t<Iterator>>
+				&& (std::is_same_v<Comparator, std::less<std::iter_value_t<Iterator>>> || std::is_same_v<Comparator, std::less<>>);
+
+			template<typename T>
+			constexpr T padding() noexcept
+			{
+				if constexpr (std::numeric_limits<T>::has_infinity)
+					return std::numeric_limits<T>::infinity();
+				else
+					return std::numeric_limits<T>::max();
+			}
+
+			// lane i takes the maximum in the bitonic step exchanging lanes i and i ^ J of blocks K wide
+			constexpr int max_lanes_mask(int lanes, int k, int j) noexcept
+			{
+				int mask = 0;
+				for (int i = 0; i < lanes; ++i)
+				{
+					const bool ascending = (i & k) == 0;
+					if (((i & j) != 0) == ascending)
+						mask |= 1 << i;
+				}
+				return mask;
+			}
+
+			// Traits pass registers by reference only: the generic network below has no target
+			// instruction set, vector arguments by value would change its calling convention.
+			template<typename T>
+			struct scalar_traits
+			{
+				using value_type = T;
+				using register_type = T;
+				static constexpr int lanes = 1;
+
+				static void load(register_type& value, const T* data) noexcept { value = *data; }
+				static void store(T* data, const register_type& value) noexcept { *data = value; }
+				static void reverse(register_type&) noexcept { }
+
+				static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = high < low ? high : low;
+					high = low < high ? high : low;
+					low = minimum;
+				}
+			};
+
+#if SORTING_NETWORKS_X86
+			template<typename T>
+			struct sse41_traits;
+
+			template<>
+			struct sse41_traits<int>
+			{
+				using value_type = int;
+				using register_type = __m128i;
+				static constexpr int lanes = 4;
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void load(register_type& value, const int* data) noexcept
+				{ value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void store(int* data, const register_type& value) noexcept
+				{ _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void reverse(register_type& value) noexcept
+				{ value = _mm_shuffle_epi32(value, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm_min_epi32(low, high);
+					high = _mm_max_epi32(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("sse4.1") static void exchange(register_type& value) noexcept
+				{
+					register_type partner;
+					if constexpr (J == 1)
+						partner = _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1));
+					else
+						partner = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+					// the 16 bit blend takes two mask bits per lane
+					constexpr int words = (Mask & 1) * 0x03 | (Mask & 2) * 0x06 | (Mask & 4) * 0x0C | (Mask & 8) * 0x18;
+					value = _mm_blend_epi16(_mm_min_epi32(value, partner), _mm_max_epi32(value, partner), words);
+				}
+			};
+
+			template<>
+			struct sse41_traits<float>
+			{
+				using value_type = float;
+				using register_type = __m128;
+				static constexpr int lanes = 4;
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void load(register_type& value, const float* data) noexcept
+				{ value = _mm_loadu_ps(data); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void store(float* data, const register_type& value) noexcept
+				{ _mm_storeu_ps(data, value); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void reverse(register_type& value) noexcept
+				{ value = _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm_min_ps(low, high);
+					high = _mm_max_ps(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("sse4.1") static void exchange(register_type& value) noexcept
+				{
+					register_type partner;
+					if constexpr (J == 1)
+						partner = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+					else
+						partner = _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2));
+					value = _mm_blend_ps(_mm_min_ps(value, partner), _mm_max_ps(value, partner), Mask);
+				}
+			};
+
+			template<>
+			struct sse41_traits<double>
+			{
+				using value_type = double;
+				using register_type = __m128d;
+				static constexpr int lanes = 2;
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void load(register_type& value, const double* data) noexcept
+				{ value = _mm_loadu_pd(data); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void store(double* data, const register_type& value) noexcept
+				{ _mm_storeu_pd(data, value); }
+				SORTING_NETWORKS_TARGET("sse4.1") static void reverse(register_type& value) noexcept
+				{ value = _mm_shuffle_pd(value, value, 1); }
+
+				SORTING_NETWORKS_TARGET("sse4.1") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm_min_pd(low, high);
+					high = _mm_max_pd(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("sse4.1") static void exchange(register_type& value) noexcept
+				{
+					register_type partner = _mm_shuffle_pd(value, value, 1);
+					value = _mm_blend_pd(_mm_min_pd(value, partner), _mm_max_pd(value, partner), Mask);
+				}
+			};
+
+			template<typename T>
+			struct avx2_traits;
+
+			template<>
+			struct avx2_traits<int>
+			{
+				using value_type = int;
+				using register_type = __m256i;
+				static constexpr int lanes = 8;
+
+				SORTING_NETWORKS_TARGET("avx2") static void load(register_type& value, const int* data) noexcept
+				{ value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+				SORTING_NETWORKS_TARGET("avx2") static void store(int* data, const register_type& value) noexcept
+				{ _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value); }
+				SORTING_NETWORKS_TARGET("avx2") static void reverse(register_type& value) noexcept
+				{ value = _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+
+				SORTING_NETWORKS_TARGET("avx2") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm256_min_epi32(low, high);
+					high = _mm256_max_epi32(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("avx2") static void exchange(register_type& value) noexcept
+				{
+					register_type partner;
+					if constexpr (J == 1)
+						partner = _mm256_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1));
+					else if constexpr (J == 2)
+						partner = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+					else
+						partner = _mm256_permute2x128_si256(value, value, 1);
+					value = _mm256_blend_epi32(_mm256_min_epi32(value, partner), _mm256_max_epi32(value, partner), Mask);
+				}
+			};
+
+			template<>
+			struct avx2_traits<float>
+			{
+				using value_type = float;
+				using register_type = __m256;
+				static constexpr int lanes = 8;
+
+				SORTING_NETWORKS_TARGET("avx2") static void load(register_type& value, const float* data) noexcept
+				{ value = _mm256_loadu_ps(data); }
+				SORTING_NETWORKS_TARGET("avx2") static void store(float* data, const register_type& value) noexcept
+				{ _mm256_storeu_ps(data, value); }
+				SORTING_NETWORKS_TARGET("avx2") static void reverse(register_type& value) noexcept
+				{ value = _mm256_permutevar8x32_ps(value, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+
+				SORTING_NETWORKS_TARGET("avx2") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm256_min_ps(low, high);
+					high = _mm256_max_ps(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("avx2") static void exchange(register_type& value) noexcept
+				{
+					register_type partner;
+					if constexpr (J == 1)
+						partner = _mm256_permute_ps(value, _MM_SHUFFLE(2, 3, 0, 1));
+					else if constexpr (J == 2)
+						partner = _mm256_permute_ps(value, _MM_SHUFFLE(1, 0, 3, 2));
+					else
+						partner = _mm256_permute2f128_ps(value, value, 1);
+					value = _mm256_blend_ps(_mm256_min_ps(value, partner), _mm256_max_ps(value, partner), Mask);
+				}
+			};
+
+			template<>
+			struct avx2_traits<double>
+			{
+				using value_type = double;
+				using register_type = __m256d;
+				static constexpr int lanes = 4;
+
+				SORTING_NETWORKS_TARGET("avx2") static void load(register_type& value, const double* data) noexcept
+				{ value = _mm256_loadu_pd(data); }
+				SORTING_NETWORKS_TARGET("avx2") static void store(double* data, const register_type& value) noexcept
+				{ _mm256_storeu_pd(data, value); }
+				SORTING_NETWORKS_TARGET("avx2") static void reverse(register_type& value) noexcept
+				{ value = _mm256_permute4x64_pd(value, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+				SORTING_NETWORKS_TARGET("avx2") static void compare_exchange(register_type& low, register_type& high) noexcept
+				{
+					const register_type minimum = _mm256_min_pd(low, high);
+					high = _mm256_max_pd(low, high);
+					low = minimum;
+				}
+
+				template<int J, int Mask>
+				SORTING_NETWORKS_TARGET("avx2") static void exchange(register_type& value) noexcept
+				{
+					register_type partner;
+					if constexpr (J == 1)
+						partner = _mm256_permute_pd(value, 0b0101);
+					else
+						partner = _mm256_permute2f128_pd(value, value, 1);
+					value = _mm256_blend_pd(_mm256_min_pd(value, partner), _mm256_max_pd(value, partner), Mask);
+				}
+			};
+#endif
+
+			template<typename Traits, int K, int J>
+			void lanes_step(typename Traits::register_type& value) noexcept
+			{
+				Traits::template exchange<J, max_lanes_mask(Traits::lanes, K, J)>(value);
+			}
+
+			template<typename Traits>
+			void sort_lanes(typename Traits::register_type& value) noexcept
+			{
+				constexpr int lanes = Traits::lanes;
+				if constexpr (lanes >= 2)
+					lanes_step<Traits, 2, 1>(value);
+				if constexpr (lanes >= 4)
+				{
+					lanes_step<Traits, 4, 2>(value);
+					lanes_step<Traits, 4, 1>(value);
+				}
+				if constexpr (lanes >= 8)
+				{
+					lanes_step<Traits, 8, 4>(value);
+					lanes_step<Traits, 8, 2>(value);
+					lanes_step<Traits, 8, 1>(value);
+				}
+			}
+
+			// a bitonic register becomes ascending
+			template<typename Traits>
+			void clean_lanes(typename Traits::register_type& value) noexcept
+			{
+				constexpr int lanes = Traits::lanes;
+				if constexpr (lanes >= 8)
+					lanes_step<Traits, lanes, 4>(value);
+				if constexpr (lanes >= 4)
+					lanes_step<Traits, lanes, 2>(value);
+				if constexpr (lanes >= 2)
+					lanes_step<Traits, lanes, 1>(value);
+			}
+
+			template<typename Traits, size_t Width>
+			void merge_groups(typename Traits::register_type* registers) noexcept
+			{
+				auto* second = registers + Width;
+				for (size_t i = 0; i < Width / 2; ++i)
+					std::swap(second[i], second[Width - 1 - i]);
+				for (size_t i = 0; i < Width; ++i)
+				{
+					Traits::reverse(second[i]);
+					Traits::compare_exchange(registers[i], second[i]);
+				}
+
+				for (size_t gap = Width / 2; gap > 0; gap /= 2)
+				{
+					for (size_t i = 0; i < 2 * Width; ++i)
+					{
+						if ((i & gap) == 0)
+							Traits::compare_exchange(registers[i], registers[i + gap]);
+					}
+				}
+
+				for (size_t i = 0; i < 2 * Width; ++i)
+					clean_lanes<Traits>(registers[i]);
+			}
+
+			template<typename Traits, size_t Width, size_t Registers>
+			void merge_levels(typename Traits::register_type* registers) noexcept
+			{
+				if constexpr (Width < Registers)
+				{
+					for (size_t group = 0; group < Registers; group += 2 * Width)
+						merge_groups<Traits, Width>(registers + group);
+					merge_levels<Traits, 2 * Width, Registers>(registers);
+				}
+			}
+
+			template<typename Traits, size_t Registers>
+			void sort_padded(typename Traits::value_type* data, size_t size) noexcept
+			{
+				using value_type = typename Traits::value_type;
+				constexpr size_t lanes = Traits::lanes;
+
+				alignas(32) value_type block[Registers * lanes];
+				std::memcpy(block, data, size * sizeof(value_type));
+				std::fill(block + size, block + Registers * lanes, padding<value_type>());
+
+				typename Traits::register_type registers[Registers];
+				for (size_t i = 0; i < Registers; ++i)
+				{
+					Traits::load(registers[i], block + i * lanes);
+					sort_lanes<Traits>(registers[i]);
+				}
+				merge_levels<Traits, 1, Registers>(registers);
+				for (size_t i = 0; i < Registers; ++i)
+					Traits::store(block + i * lanes, registers[i]);
+
+				std::memcpy(data, block, size * sizeof(value_type));
+			}
+
+			// the smallest power of two number of registers holding size elements
+			template<typename Traits, size_t Registers = 1>
+			void sort_block(typename Traits::value_type* data, size_t size) noexcept
+			{
+				if constexpr (Registers * Traits::lanes >= network_max_size)
+					sort_padded<Traits, Registers>(data, size);
+				else if (size <= Registers * Traits::lanes)
+					sort_padded<Traits, Registers>(data, size);
+				else
+					sort_block<Traits, 2 * Registers>(data, size);
+			}
+
+			template<network_value T>
+			SORTING_NETWORKS_FLATTEN void sort_scalar(T* data, size_t size) noexcept
+			{
+				sort_block<scalar_traits<T>>(data, size);
+			}
+
+#if SORTING_NETWORKS_X86
+			template<network_value T>
+			SORTING_NETWORKS_TARGET("sse4.1") SORTING_NETWORKS_FLATTEN void sort_sse41(T* data, size_t size) noexcept
+			{
+				sort_block<sse41_traits<T>>(data, size);
+			}
+
+			template<network_value T>
+			SORTING_NETWORKS_TARGET("avx2") SORTING_NETWORKS_FLATTEN void sort_avx2(T* data, size_t size) noexcept
+			{
+				sort_block<avx2_traits<T>>(data, size);
+			}
+#endif
+
+			template<network_value T>
+			void sort(T* data, size_t size, simd_level level) noexcept
+			{
+#if SORTING_NETWORKS_X86
+				if (level == simd_level::avx2)
+					return sort_avx2(data, size);
+				if (level == simd_level::sse41)
+					return sort_sse41(data, size);
+#endif
+				sort_scalar(data, size);
+			}
+
+			// detected once, the first time a network sort runs
+			inline simd_level cached_simd_level() noexcept
+			{
+				static const simd_level level = detect_simd_level();
+				return level;
+			}
+
+			// size <= network_max_size
+			template<network_value T>
+			void sort(T* data, size_t size) noexcept
+			{
+				sort(data, size, cached_simd_level());
+			}
+		}
+	}
+
+
+	// Ascending sort of at most network_max_size int, float or double values with a
+	// sorting network on the given instruction set, it has to be supported.
+	template<std::contiguous_iterator Iterator>
+	requires detail::network::network_value<std::iter_value_t<Iterator>>
+	void NetworkSort(Iterator begin_it, Iterator end_it, simd_level level)
+	{
+		const auto size = static_cast<size_t>(end_it - begin_it);
+		if (size > network_max_size)
+		{
+			throw std::out_of_range(
+				"in NetworkSort range is too long (size) " + std::to_string(size)
+				+ " > (network_max_size) " + std::to_string(network_max_size));
+		}
+		if (size > 1)
+			detail::network::sort(std::to_address(begin_it), size, level);
+	}
+
+	// the widest instruction set the processor has
+	template<std::contiguous_iterator Iterator>
+	requires detail::network::network_value<std::iter_value_t<Iterator>>
+	void NetworkSort(Iterator begin_it, Iterator end_it)
+	{
+		NetworkSort(begin_it, end_it, detail::network::cached_simd_level());
+	}
+}
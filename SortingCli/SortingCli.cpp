@@ -4,12 +4,15 @@
 #include <thread>
 #include <fstream>
 #include <sstream>
+#include <memory_resource>
 
 #include "list_sequence.h"
 #include "array_sequence.h"
+#include "indexed_sequence.h"
 #include "Sorting.h"
 #include "utils.h"
 #include "testing.h"
+#include "benchmark.h"
 #include <boost/mpl/vector.hpp>
 
 using namespace collections;
@@ -36,7 +39,10 @@ template<typename T>
 using b = boost::mpl::vector<std::vector<T>, std::list<T>, linked_list<T>, dynamic_array<T>, array_sequence<T>, list_sequence<T>>;
 template<typename T>
 using c = boost::mpl::vector<std::vector<T>, std::deque<T>>;
+template<typename T>
+using r = boost::mpl::vector<std::vector<T>, std::deque<T>, dynamic_array<T>>;
 using a = boost::mpl::vector<int, float, std::pair<int, int>>;
+using int_pair = std::pair<int, int>;
 
 template<typename Lambda>
 void type_combined_test(Lambda lambda)
@@ -50,6 +56,12 @@ void type_combined_test2(Lambda lambda)
 	testing::type_combined_test_template<Lambda, c, a>(lambda);
 }
 
+template<typename Lambda>
+void type_combined_test3(Lambda lambda)
+{
+	testing::type_combined_test_template<Lambda, r, a>(lambda);
+}
+
 void proof_of_work_bidirectional()
 {
 	type_combined_test([&]<typename T, typename C>(T t, C c)
@@ -108,6 +120,186 @@ void proof_of_work_random_access()
 		});
 }
 
+void proof_of_work_pdqsort()
+{
+	type_combined_test3([&]<typename T, typename C>(T t, C c)
+		{
+			auto random = random_generator<T>();
+			for (size_t length : {0, 1, 10, 100, 1000, 10000})
+			{
+				C container(length);
+				auto begin_it = std::begin(container), end_it = std::end(container);
+
+				// random, sorted, reversed, organ pipe, all equal
+				std::generate(begin_it, end_it, random);
+				PdqSort(begin_it, end_it);
+				testing::assert(std::is_sorted(begin_it, end_it));
+
+				PdqSort(begin_it, end_it);
+				testing::assert(std::is_sorted(begin_it, end_it));
+
+				PdqSort(begin_it, end_it, std::greater<T>{});
+				testing::assert(std::is_sorted(begin_it, end_it, std::greater<T>{}));
+
+				std::reverse(std::next(begin_it, length / 2), end_it);
+				PdqSort(begin_it, end_it, std::greater<T>{});
+				testing::assert(std::is_sorted(begin_it, end_it, std::greater<T>{}));
+
+				if (length != 0)
+					std::fill(begin_it, end_it, *begin_it);
+				PdqSort(begin_it, end_it);
+				testing::assert(std::is_sorted(begin_it, end_it));
+			}
+		});
+}
+
+void proof_of_work_radix()
+{
+	type_combined_test3([&]<typename T, typename C>(T t, C c)
+		{
+			auto random = random_generator<T>();
+			for (size_t length : {0, 1, 10, 100, 1000, 100000})
+			{
+				C container(length);
+				std::generate(std::begin(container), std::end(container), random);
+				RadixSort(std::begin(container), std::end(container));
+				testing::assert(std::is_sorted(std::begin(container), std::end(container)));
+			}
+		});
+
+	std::vector<std::string> strings(100000);
+	std::generate(std::begin(strings), std::end(strings), random_generator<std::string>());
+	RadixSort(std::begin(strings), std::end(strings));
+	testing::assert(std::is_sorted(std::begin(strings), std::end(strings)));
+
+	std::vector<std::pair<int, int>> pairs(100000);
+	std::generate(std::begin(pairs), std::end(pairs), random_generator<std::pair<int, int>>());
+	RadixSort(std::begin(pairs), std::end(pairs), [](const std::pair<int, int>& pair) { return pair.second; });
+	testing::assert(std::is_sorted(std::begin(pairs), std::end(pairs),
+		[](const auto& left, const auto& right) { return left.second < right.second; }));
+}
+
+void proof_of_work_selection()
+{
+	type_combined_test([&]<typename T, typename C>(T t, C c)
+		{
+			auto random = random_generator<T>();
+			for (size_t length : {1, 10, 100, 1000, 10000})
+			{
+				C container(length);
+				std::generate(std::begin(container), std::end(container), random);
+				std::vector<T> sorted(std::begin(container), std::end(container));
+				std::sort(std::begin(sorted), std::end(sorted));
+
+				const size_t k = length / 3;
+				auto top = TopK(std::begin(container), std::end(container), k);
+				testing::assert(std::equal(std::begin(top), std::end(top), std::begin(sorted), std::begin(sorted) + k));
+
+				auto nth = std::next(std::begin(container), k);
+				NthElement(std::begin(container), nth, std::end(container));
+				testing::assert(*nth == sorted[k]);
+
+				PartialSort(std::begin(container), nth, std::end(container));
+				testing::assert(std::equal(std::begin(container), nth, std::begin(sorted)));
+			}
+		});
+}
+
+void proof_of_work_external()
+{
+	const auto directory = std::filesystem::temp_directory_path();
+	external_options options{ .memory_budget = 1 << 16, .buffer_size = 1 << 12, .temp_directory = directory };
+
+	std::vector<int> numbers(100000);
+	std::generate(std::begin(numbers), std::end(numbers), random_generator<int>());
+	{
+		std::ofstream file(directory / "external_input.bin", std::ios::binary);
+		file.write(reinterpret_cast<const char*>(numbers.data()), numbers.size() * sizeof(int));
+	}
+	ExternalSort<int>(directory / "external_input.bin", directory / "external_output.bin", std::less<int>{}, options);
+
+	std::vector<int> sorted(numbers.size());
+	{
+		std::ifstream file(directory / "external_output.bin", std::ios::binary);
+		file.read(reinterpret_cast<char*>(sorted.data()), sorted.size() * sizeof(int));
+	}
+	std::sort(std::begin(numbers), std::end(numbers));
+	testing::assert(sorted == numbers);
+
+	std::vector<std::string> lines(10000);
+	std::generate(std::begin(lines), std::end(lines), random_generator<std::string>());
+	{
+		std::ofstream file(directory / "external_input.txt");
+		for (const auto& line : lines)
+			file << line << '\n';
+	}
+	ExternalSortLines(directory / "external_input.txt", directory / "external_output.txt", std::less<std::string>{}, options);
+
+	std::vector<std::string> sorted_lines;
+	{
+		std::ifstream file(directory / "external_output.txt");
+		for (std::string line; std::getline(file, line);)
+			sorted_lines.push_back(line);
+	}
+	std::sort(std::begin(lines), std::end(lines));
+	testing::assert(sorted_lines == lines);
+
+	for (const char* name : { "external_input.bin", "external_output.bin", "external_input.txt", "external_output.txt" })
+		std::filesystem::remove(directory / name);
+}
+
+void proof_of_work_sort_dispatch()
+{
+	type_combined_test([&]<typename T, typename C>(T t, C c)
+		{
+			auto random = random_generator<T>();
+			for (size_t length : {0, 1, 10, 100, 1000, 10000})
+			{
+				C container(length);
+				std::generate(std::begin(container), std::end(container), random);
+				Sort(container);
+				testing::assert(std::is_sorted(std::begin(container), std::end(container)));
+
+				// sorted and reversed input go through the presortedness probe
+				Sort(std::begin(container), std::end(container));
+				testing::assert(std::is_sorted(std::begin(container), std::end(container)));
+				Sort(std::begin(container), std::end(container), std::greater<T>{});
+				testing::assert(std::is_sorted(std::begin(container), std::end(container), std::greater<T>{}));
+			}
+		});
+
+	std::vector<std::string> engines;
+	std::vector<int> numbers(100000);
+	std::generate(std::begin(numbers), std::end(numbers), random_generator<int>());
+	Sort(std::begin(numbers), std::end(numbers), std::less<int>{},
+		[&](const sort_decision& decision) { engines.push_back(to_string(decision.engine)); });
+	testing::assert(engines.size() == 1 && std::is_sorted(std::begin(numbers), std::end(numbers)));
+}
+
+void proof_of_work_network()
+{
+	auto check = [&]<typename T>(T)
+	{
+		auto random = random_generator<T>();
+		const simd_level detected = detect_simd_level();
+		for (simd_level level : { simd_level::scalar, simd_level::sse41, simd_level::avx2 })
+		{
+			if (level > detected)
+				continue;
+			for (size_t length = 0; length <= network_max_size; ++length)
+			{
+				std::vector<T> container(length);
+				std::generate(std::begin(container), std::end(container), random);
+				NetworkSort(std::begin(container), std::end(container), level);
+				testing::assert(std::is_sorted(std::begin(container), std::end(container)));
+			}
+		}
+	};
+	check(int{});
+	check(float{});
+	check(double{});
+}
+
 // test_name;container_type;inner_type;elements;total_time
 void profile_bubble_sort_with_100_int(std::ostream& file)
 {
@@ -122,86 +314,434 @@ void profile_bubble_sort_with_100_int(std::ostream& file)
 	file << std::endl;
 }
 
-#define SORT_PROFILE_CSV(FILE, SORT, CONTAINER, TYPE, LENGTH)					\
-{																				\
-	CONTAINER<TYPE> container(static_cast<size_t>(LENGTH));						\
-	auto random = random_generator<TYPE>();										\
-	std::generate(std::begin(container), std::end(container), random);			\
-	FILE << #SORT << "," << #CONTAINER << "," << #TYPE << "," << LENGTH << ","; \
-	{																			\
-		profiler p("",std::cerr, [&](long long ms) { FILE << ms; });			\
-		SORT(std::begin(container), std::end(container));						\
-	}																			\
-	FILE << std::endl;															\
+// names of the benchmarked types in reports
+template<typename T>
+struct name_of;
+
+template<> struct name_of<int> { static constexpr const char* value = "int"; };
+template<> struct name_of<float> { static constexpr const char* value = "float"; };
+template<> struct name_of<double> { static constexpr const char* value = "double"; };
+template<> struct name_of<int_pair> { static constexpr const char* value = "int_pair"; };
+template<> struct name_of<std::string> { static constexpr const char* value = "std::string"; };
+template<typename T> struct name_of<std::vector<T>> { static constexpr const char* value = "std::vector"; };
+template<typename T> struct name_of<std::list<T>> { static constexpr const char* value = "std::list"; };
+template<typename T> struct name_of<dynamic_array<T>> { static constexpr const char* value = "dynamic_array"; };
+template<typename T> struct name_of<linked_list<T>> { static constexpr const char* value = "linked_list"; };
+template<typename T> struct name_of<pooled_linked_list<T>> { static constexpr const char* value = "pooled_linked_list"; };
+
+template<typename T>
+using all_containers = boost::mpl::vector<std::vector<T>, std::list<T>, dynamic_array<T>, linked_list<T>, pooled_linked_list<T>>;
+template<typename T>
+using random_access_containers = boost::mpl::vector<std::vector<T>, dynamic_array<T>>;
+template<typename T>
+using node_containers = boost::mpl::vector<std::list<T>, linked_list<T>, pooled_linked_list<T>>;
+template<typename T>
+using dispatch_containers = boost::mpl::vector<std::vector<T>, std::list<T>, dynamic_array<T>, linked_list<T>>;
+template<typename T>
+using vector_container = boost::mpl::vector<std::vector<T>>;
+template<typename T>
+using linked_list_container = boost::mpl::vector<linked_list<T>>;
+using int_string = boost::mpl::vector<int, std::string>;
+using float_pair = boost::mpl::vector<float, int_pair>;
+using int_only = boost::mpl::vector<int>;
+
+// every input distribution of one sort on one container type, containers are refilled untimed before each run
+template<typename Container, typename T, typename SortFunction>
+void benchmark_sort(benchmark_report& report, const benchmark_options& options,
+	const std::string& sort_name, size_t length, SortFunction sort)
+{
+	for (distribution input : all_distributions)
+	{
+		const auto values = make_input<T>(input, length);
+		const auto stats = measure(
+			[&]()
+			{
+				Container container(length);
+				std::copy(std::begin(values), std::end(values), std::begin(container));
+				return container;
+			},
+			[&](Container& container) { sort(container); },
+			options);
+		report.add({ sort_name, name_of<Container>::value, name_of<T>::value, input, length, stats });
+	}
+}
+
+// the sort on every container of Containers for every element type of Types
+template<template<typename ...arg> typename Containers, typename Types, typename SortFunction>
+void benchmark_sorts(benchmark_report& report, const benchmark_options& options,
+	const std::string& sort_name, size_t length, SortFunction sort)
+{
+	auto benchmark = [&]<typename T, typename C>(T, C)
+	{
+		benchmark_sort<C, T>(report, options, sort_name, length, sort);
+	};
+	testing::type_combined_test_template<decltype(benchmark), Containers, Types>(benchmark);
+}
+
+// sort_type;container_type;inner_type;distribution;elements;statistics
+void benchmark_sort_matrix(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	const auto& options = arguments.options;
+	for (size_t i : {10, 100, 500, 1000, 2000, 5000, 7000, 10000, 20000, 50000, 70000, 100000, 200000, 500000, 700000, 1000000, 2000000, 10000000})
+	{
+		if (i > arguments.max_length)
+			break;
+
+		if (i < 100000)
+		{
+			benchmark_sorts<all_containers, int_string>(report, options, "BubbleSort", i,
+				[](auto& container) { BubbleSort(std::begin(container), std::end(container)); });
+			benchmark_sorts<all_containers, int_string>(report, options, "SelectionSort", i,
+				[](auto& container) { SelectionSort(std::begin(container), std::end(container)); });
+		}
+
+		benchmark_sorts<all_containers, int_string>(report, options, "MergeSort", i,
+			[](auto& container) { MergeSort(std::begin(container), std::end(container)); });
+		benchmark_sorts<random_access_containers, int_string>(report, options, "std::stable_sort", i,
+			[](auto& container) { std::stable_sort(std::begin(container), std::end(container)); });
+		benchmark_sorts<node_containers, int_string>(report, options, "::sort", i,
+			[](auto& container) { container.sort(); });
+		benchmark_sorts<all_containers, int_string>(report, options, "QuickSort", i,
+			[](auto& container) { QuickSort(std::begin(container), std::end(container)); });
+
+		auto std_sort = [](auto& container) { std::sort(std::begin(container), std::end(container)); };
+		benchmark_sorts<random_access_containers, int_string>(report, options, "std::sort", i, std_sort);
+		benchmark_sorts<vector_container, float_pair>(report, options, "std::sort", i, std_sort);
+
+		auto pdq_sort = [](auto& container) { PdqSort(std::begin(container), std::end(container)); };
+		benchmark_sorts<random_access_containers, int_string>(report, options, "PdqSort", i, pdq_sort);
+		benchmark_sorts<vector_container, float_pair>(report, options, "PdqSort", i, pdq_sort);
+
+		auto radix_sort = [](auto& container) { RadixSort(std::begin(container), std::end(container)); };
+		benchmark_sorts<random_access_containers, int_string>(report, options, "RadixSort", i, radix_sort);
+		benchmark_sorts<vector_container, float_pair>(report, options, "RadixSort", i, radix_sort);
+		benchmark_sorts<linked_list_container, int_only>(report, options, "RadixSort", i, radix_sort);
+
+		auto adaptive_sort = [](auto& container) { Sort(std::begin(container), std::end(container)); };
+		benchmark_sorts<dispatch_containers, int_only>(report, options, "Sort", i, adaptive_sort);
+		benchmark_sorts<random_access_containers, boost::mpl::vector<std::string>>(report, options, "Sort", i, adaptive_sort);
+		benchmark_sorts<vector_container, float_pair>(report, options, "Sort", i, adaptive_sort);
+	}
+}
+
+
+// allocator;container_type;inner_type;elements;statistics, filling and merge sorting a container
+template<typename Container, typename PmrContainer>
+void benchmark_allocator(benchmark_report& report, const benchmark_options& options,
+	const std::string& container_name, size_t length)
+{
+	using T = typename Container::value_type;
+	const auto values = make_input<T>(distribution::random, length);
+
+	// every run gets a fresh resource, it is released after the timer stops
+	auto fill_and_sort = [&](const std::string& allocator_name, auto make_resource, auto make_container)
+	{
+		const auto stats = measure(make_resource,
+			[&](auto& resource)
+			{
+				auto container = make_container(resource);
+				for (const auto& value : values)
+					container.push_back(value);
+				MergeSort(std::begin(container), std::end(container));
+			},
+			options);
+		report.add({ allocator_name, container_name, name_of<T>::value, distribution::random, length, stats });
+	};
+
+	fill_and_sort("std::allocator", [] { return nullptr; }, [](std::nullptr_t) { return Container{}; });
+	fill_and_sort("monotonic_buffer_resource",
+		[] { return std::make_unique<std::pmr::monotonic_buffer_resource>(); },
+		[](auto& arena) { return PmrContainer(arena.get()); });
+	fill_and_sort("unsynchronized_pool_resource",
+		[] { return std::make_unique<std::pmr::unsynchronized_pool_resource>(); },
+		[](auto& pool) { return PmrContainer(pool.get()); });
+}
+
+void benchmark_allocators(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	for (size_t i : {1000, 10000, 100000, 1000000})
+	{
+		if (i > arguments.max_length)
+			break;
+		benchmark_allocator<dynamic_array<int>, pmr::dynamic_array<int>>(report, arguments.options, "dynamic_array", i);
+		benchmark_allocator<linked_list<int>, pmr::linked_list<int>>(report, arguments.options, "linked_list", i);
+		benchmark_allocator<dynamic_array<std::string>, pmr::dynamic_array<std::string>>(report, arguments.options, "dynamic_array", i);
+		benchmark_allocator<linked_list<std::string>, pmr::linked_list<std::string>>(report, arguments.options, "linked_list", i);
+	}
 }
 
+// container;operation;elements;allocations;bytes
+template<typename Container>
+void profile_companion_allocations_csv(std::ostream& file, const std::string& container_name, size_t length)
+{
+	using T = typename Container::value_type;
+	auto make = [](size_t n)
+	{
+		auto random = random_generator<T>();
+		Container container;
+		for (size_t i = 0; i < n; ++i)
+			container.push_back(random());
+		return sequence<Container>(std::move(container));
+	};
+	auto count = [&](const std::string& operation, auto&& action)
+	{
+		auto seq = make(length);
+		auto other = make(length / 10);
+		allocation_counter::reset();
+		action(seq, std::move(other));
+		file << container_name << "," << operation << "," << length << ","
+			<< allocation_counter::allocations << "," << allocation_counter::bytes << std::endl;
+	};
 
+	count("append_back_mut", [](auto& seq, auto other) { seq.append_back_mut(std::move(other)); });
+	count("append_front_mut", [](auto& seq, auto other) { seq.append_front_mut(std::move(other)); });
+	count("insert_mut", [length](auto& seq, auto other) { seq.insert_mut(length / 2, std::move(other)); });
+	count("cut_mut", [length](auto& seq, auto) { auto parts = seq.cut_mut(length / 2); });
+	count("extract_subsequence", [length](auto& seq, auto) { auto middle = seq.extract_subsequence(length / 4, length / 2); });
+}
 
-int main()
+void profile_companion_allocations(std::ostream& file)
 {
+	file << "Container,Operation,Elements,Allocations,Bytes" << std::endl;
+	for (size_t i : {1000, 10000, 100000, 1000000})
+	{
+		profile_companion_allocations_csv<dynamic_array<int, counting_allocator<int>>>(file, "dynamic_array", i);
+		profile_companion_allocations_csv<linked_list<int, counting_allocator<int>>>(file, "linked_list", i);
+		profile_companion_allocations_csv<std::vector<int, counting_allocator<int>>>(file, "std::vector", i);
+		profile_companion_allocations_csv<indexed_list<int, counting_allocator<int>>>(file, "indexed_list", i);
+	}
+}
 
-	using namespace std::chrono_literals;
+// sort_type threads;std::vector;inner_type;elements;statistics
+template<typename T>
+void benchmark_parallel_scaling_of(benchmark_report& report, const benchmark_options& options, size_t length)
+{
+	const auto values = make_input<T>(distribution::random, length);
 
-	auto tr = test_runner();
-	tr RUN_TEST(proof_of_work_bidirectional);
+	auto benchmark = [&](const std::string& sort_name, size_t threads, auto sort)
+	{
+		const auto stats = measure([&] { return values; }, [&](std::vector<T>& container) { sort(container, threads); }, options);
+		report.add({ sort_name + " " + std::to_string(threads) + " threads", "std::vector", name_of<T>::value,
+			distribution::random, length, stats });
+	};
 
-	if (true)
+	benchmark("std::sort", 1, [](auto& container, size_t) { std::sort(std::begin(container), std::end(container)); });
+	for (size_t threads = 1; threads <= std::max<size_t>(1, std::thread::hardware_concurrency()); threads *= 2)
+	{
+		benchmark("ParallelMergeSort", threads, [](auto& container, size_t threads)
+			{ ParallelMergeSort(std::begin(container), std::end(container), std::less<T>{}, { .thread_count = threads }); });
+		benchmark("ParallelSampleSort", threads, [](auto& container, size_t threads)
+			{ ParallelSampleSort(std::begin(container), std::end(container), std::less<T>{}, { .thread_count = threads }); });
+	}
+}
+
+void benchmark_parallel_scaling(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	for (size_t i : {1000000, 10000000, 50000000})
+	{
+		if (i > arguments.max_length)
+			break;
+		benchmark_parallel_scaling_of<int>(report, arguments.options, i);
+		benchmark_parallel_scaling_of<float>(report, arguments.options, i);
+	}
+	if (1000000 <= arguments.max_length)
+		benchmark_parallel_scaling_of<std::string>(report, arguments.options, 1000000);
+}
+
+// sort_type;std::vector;inner_type;block_size;statistics, a run sorts every block of network_blocks
+inline constexpr size_t network_blocks = 200000;
+
+template<typename T>
+void benchmark_network_kernels_of(benchmark_report& report, const benchmark_options& options, size_t block_size)
+{
+	const auto values = make_input<T>(distribution::random, block_size * network_blocks);
+
+	auto benchmark = [&](const std::string& sort_name, auto sort)
 	{
-		std::ofstream file(R"(C:\Users\Ariel\Desktop\profiling.csv)");
-		file << "SortType,Container,InnerType,Elements,Time" << std::endl;
+		const auto stats = measure([&] { return values; },
+			[&](std::vector<T>& container)
+			{
+				for (auto it = std::begin(container); it != std::end(container); it += block_size)
+					sort(it, it + block_size);
+			},
+			options);
+		report.add({ sort_name, "std::vector", name_of<T>::value, distribution::random, block_size, stats });
+	};
 
-		for (int i : {10, 100, 500, 1000, 2000, 5000, 7000, 10000, 20000, 50000, 70000, 100000, 200000, 500000, 700000, 1000000, 2000000, 10000000})
+	const simd_level detected = detect_simd_level();
+	benchmark("NetworkSort scalar", [](auto begin_it, auto end_it) { NetworkSort(begin_it, end_it, simd_level::scalar); });
+	if (detected >= simd_level::sse41)
+		benchmark("NetworkSort sse4.1", [](auto begin_it, auto end_it) { NetworkSort(begin_it, end_it, simd_level::sse41); });
+	if (detected >= simd_level::avx2)
+		benchmark("NetworkSort avx2", [](auto begin_it, auto end_it) { NetworkSort(begin_it, end_it, simd_level::avx2); });
+	benchmark("insertion sort", [](auto begin_it, auto end_it)
 		{
-			if (i < 100000)
+			std::less<T> cmp;
+			sorting::detail::pdq::insertion_sort(begin_it, end_it, cmp);
+		});
+	benchmark("std::sort", [](auto begin_it, auto end_it) { std::sort(begin_it, end_it); });
+}
+
+void benchmark_network_kernels(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	for (size_t i : {8, 16, 24, 32, 48, 64})
+	{
+		benchmark_network_kernels_of<int>(report, arguments.options, i);
+		benchmark_network_kernels_of<float>(report, arguments.options, i);
+		benchmark_network_kernels_of<double>(report, arguments.options, i);
+	}
+}
+
+// select_type k;std::vector;inner_type;elements;statistics
+template<typename T>
+void benchmark_selection_of(benchmark_report& report, const benchmark_options& options, size_t length, size_t k)
+{
+	const auto values = make_input<T>(distribution::random, length);
+
+	auto benchmark = [&](const std::string& select_name, auto select)
+	{
+		const auto stats = measure([&] { return values; }, [&](std::vector<T>& container) { select(container); }, options);
+		report.add({ select_name + " k=" + std::to_string(k), "std::vector", name_of<T>::value,
+			distribution::random, length, stats });
+	};
+
+	benchmark("PdqSort", [](auto& container) { PdqSort(std::begin(container), std::end(container)); });
+	benchmark("NthElement", [k](auto& container) { NthElement(std::begin(container), std::begin(container) + k, std::end(container)); });
+	benchmark("std::nth_element", [k](auto& container) { std::nth_element(std::begin(container), std::begin(container) + k, std::end(container)); });
+	benchmark("PartialSort", [k](auto& container) { PartialSort(std::begin(container), std::begin(container) + k, std::end(container)); });
+	benchmark("std::partial_sort", [k](auto& container) { std::partial_sort(std::begin(container), std::begin(container) + k, std::end(container)); });
+	benchmark("TopK", [k](auto& container) { auto top = TopK(std::begin(container), std::end(container), k); });
+}
+
+void benchmark_selection(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	for (size_t i : {100000, 1000000, 10000000})
+	{
+		if (i > arguments.max_length)
+			break;
+		for (size_t k : {size_t(10), size_t(1000), i / 2})
+		{
+			benchmark_selection_of<int>(report, arguments.options, i, k);
+			benchmark_selection_of<std::string>(report, arguments.options, i / 10, k / 10);
+		}
+	}
+}
+
+// ExternalSort budget;file;int;elements;statistics, runs, merges and io time of the last run go to the console
+void benchmark_external_sort(benchmark_report& report, const benchmark_arguments& arguments)
+{
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto input = directory / "external_profile.bin", output = directory / "external_profile_sorted.bin";
+
+	for (size_t length : {1000000, 10000000, 100000000})
+	{
+		if (length > arguments.max_length)
+			break;
+		{
+			std::ofstream data(input, std::ios::binary);
+			auto random = random_generator<int>();
+			std::vector<int> chunk(1 << 16);
+			for (size_t written = 0; written < length; written += chunk.size())
 			{
-				SORT_PROFILE_CSV(file, BubbleSort, std::vector, int, i)
-				SORT_PROFILE_CSV(file, BubbleSort, std::list, int, i)
-				SORT_PROFILE_CSV(file, BubbleSort, dynamic_array, int, i)
-				SORT_PROFILE_CSV(file, BubbleSort, linked_list, int, i)
-				SORT_PROFILE_CSV(file, BubbleSort, std::vector, std::string, i)
-				SORT_PROFILE_CSV(file, BubbleSort, std::list, std::string, i)
-				SORT_PROFILE_CSV(file, BubbleSort, dynamic_array, std::string, i)
-				SORT_PROFILE_CSV(file, BubbleSort, linked_list, std::string, i)
-
-				SORT_PROFILE_CSV(file, SelectionSort, std::vector, int, i)
-				SORT_PROFILE_CSV(file, SelectionSort, std::list, int, i)
-				SORT_PROFILE_CSV(file, SelectionSort, dynamic_array, int, i)
-				SORT_PROFILE_CSV(file, SelectionSort, linked_list, int, i)
-				SORT_PROFILE_CSV(file, SelectionSort, std::vector, std::string, i)
-				SORT_PROFILE_CSV(file, SelectionSort, std::list, std::string, i)
-				SORT_PROFILE_CSV(file, SelectionSort, dynamic_array, std::string, i)
-				SORT_PROFILE_CSV(file, SelectionSort, linked_list, std::string, i)
+				std::generate(std::begin(chunk), std::end(chunk), random);
+				data.write(reinterpret_cast<const char*>(chunk.data()), std::min(chunk.size(), length - written) * sizeof(int));
 			}
+		}
 
-				SORT_PROFILE_CSV(file, MergeSort, std::vector, int, i)
-				SORT_PROFILE_CSV(file, MergeSort, std::list, int, i)
-				SORT_PROFILE_CSV(file, MergeSort, dynamic_array, int, i)
-				SORT_PROFILE_CSV(file, MergeSort, linked_list, int, i)
-				SORT_PROFILE_CSV(file, MergeSort, std::vector, std::string, i)
-				SORT_PROFILE_CSV(file, MergeSort, std::list, std::string, i)
-				SORT_PROFILE_CSV(file, MergeSort, dynamic_array, std::string, i)
-				SORT_PROFILE_CSV(file, MergeSort, linked_list, std::string, i)
-
-				SORT_PROFILE_CSV(file, QuickSort, std::vector, int, i)
-				SORT_PROFILE_CSV(file, QuickSort, std::list, int, i)
-				SORT_PROFILE_CSV(file, QuickSort, dynamic_array, int, i)
-				SORT_PROFILE_CSV(file, QuickSort, linked_list, int, i)
-				SORT_PROFILE_CSV(file, QuickSort, std::vector, std::string, i)
-				SORT_PROFILE_CSV(file, QuickSort, std::list, std::string, i)
-				SORT_PROFILE_CSV(file, QuickSort, dynamic_array, std::string, i)
-				SORT_PROFILE_CSV(file, QuickSort, linked_list, std::string, i)
-
-				SORT_PROFILE_CSV(file, std::sort, std::vector, int, i)
-				//SORT_PROFILE_CSV(file, std::sort, std::list, int, i)
-				SORT_PROFILE_CSV(file, std::sort, dynamic_array, int, i)
-				//SORT_PROFILE_CSV(file, std::sort, linked_list, int, i)
-				SORT_PROFILE_CSV(file, std::sort, std::vector, std::string, i)
-				//SORT_PROFILE_CSV(file, std::sort, std::list, std::string, i)
-				SORT_PROFILE_CSV(file, std::sort, dynamic_array, std::string, i)
-				//SORT_PROFILE_CSV(file, std::sort, linked_list, std::string, i)
+		for (size_t budget : {size_t(1) << 20, size_t(16) << 20, size_t(256) << 20})
+		{
+			external_stats last;
+			const auto stats = measure([] { return 0; },
+				[&](int) { last = ExternalSort<int>(input, output, std::less<int>{}, { .memory_budget = budget }); },
+				arguments.options);
+			std::cout << "ExternalSort " << length << " ints, " << (budget >> 20) << " MiB: " << last.runs << " runs, "
+				<< last.merges << " merges, " << last.bytes_read << " bytes read, " << last.bytes_written << " written, io "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(last.io_time).count() << " ms" << std::endl;
+			report.add({ "ExternalSort " + std::to_string(budget >> 20) + " MiB", "file", "int",
+				distribution::random, length, stats });
 		}
+	}
+	std::filesystem::remove(input);
+	std::filesystem::remove(output);
+}
+
+int main(int argc, char* argv[])
+{
+	benchmark_arguments arguments;
+	try
+	{
+		arguments = benchmark_arguments::parse(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl
+			<< "usage: SortingCli [--output-dir DIR] [--format csv|json] [--warmup N] [--trials N] [--fence X] [--max-length N]" << std::endl;
+		return 1;
+	}
 
-		file.close();
+	using namespace std::chrono_literals;
+
+	auto tr = test_runner();
+	tr RUN_TEST(proof_of_work_bidirectional);
+	tr RUN_TEST(proof_of_work_pdqsort);
+	tr RUN_TEST(proof_of_work_radix);
+	tr RUN_TEST(proof_of_work_network);
+	tr RUN_TEST(proof_of_work_selection);
+	tr RUN_TEST(proof_of_work_external);
+	tr RUN_TEST(proof_of_work_sort_dispatch);
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_sort_matrix(report, arguments);
+		std::ofstream file(arguments.path("profiling"));
+		report.write(file, arguments.format);
+	}
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_allocators(report, arguments);
+		std::ofstream file(arguments.path("allocators"));
+		report.write(file, arguments.format);
+	}
+
+	if (true)
+	{
+		std::ofstream file(arguments.output_directory / "companion_allocations.csv");
+		profile_companion_allocations(file);
+	}
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_parallel_scaling(report, arguments);
+		std::ofstream file(arguments.path("parallel_scaling"));
+		report.write(file, arguments.format);
+	}
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_network_kernels(report, arguments);
+		std::ofstream file(arguments.path("network_kernels"));
+		report.write(file, arguments.format);
+	}
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_selection(report, arguments);
+		std::ofstream file(arguments.path("selection"));
+		report.write(file, arguments.format);
+	}
+
+	if (true)
+	{
+		benchmark_report report;
+		benchmark_external_sort(report, arguments);
+		std::ofstream file(arguments.path("external_sort"));
+		report.write(file, arguments.format);
 	}
 	return 0;
 }
@@ -4,6 +4,12 @@
 
 namespace collections
 {
-    template<typename T>
-    using array_sequence = sequence<dynamic_array<T>>;
+    template<typename T, typename Allocator = std::allocator<T>>
+    using array_sequence = sequence<dynamic_array<T, Allocator>>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using array_sequence = collections::array_sequence<T, std::pmr::polymorphic_allocator<T>>;
+    }
 }
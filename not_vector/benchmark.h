@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace testing
+{
+    enum class distribution { random, sorted, reversed, few_unique, organ_pipe };
+
+    inline constexpr std::array all_distributions{
+        distribution::random, distribution::sorted, distribution::reversed,
+        distribution::few_unique, distribution::organ_pipe };
+
+    inline const char* to_string(distribution input) noexcept
+    {
+        switch (input)
+        {
+        case distribution::random: return "random";
+        case distribution::sorted: return "sorted";
+        case distribution::reversed: return "reversed";
+        case distribution::few_unique: return "few_unique";
+        case distribution::organ_pipe: return "organ_pipe";
+        }
+        return "unknown";
+    }
+
+    namespace detail
+    {
+        template<typename T>
+        struct is_pair : std::false_type {};
+
+        template<typename First, typename Second>
+        struct is_pair<std::pair<First, Second>> : std::true_type {};
+
+        // the same values random_generator makes, from a seeded engine
+        template<typename T>
+        T random_value(std::mt19937& engine)
+        {
+            if constexpr (is_pair<T>::value)
+            {
+                auto first = random_value<typename T::first_type>(engine);
+                return { std::move(first), random_value<typename T::second_type>(engine) };
+            }
+            else
+            {
+                const int value = std::uniform_int_distribution<>()(engine);
+                if constexpr (std::is_same_v<T, std::string>)
+                    return std::to_string(value);
+                else
+                    return static_cast<T>(value);
+            }
+        }
+    }
+
+    // length values in the given order, the same for the same arguments
+    template<typename T>
+    std::vector<T> make_input(distribution input, size_t length, unsigned seed = 42)
+    {
+        std::mt19937 engine(seed);
+        std::vector<T> values;
+        values.reserve(length);
+
+        if (input == distribution::few_unique)
+        {
+            std::vector<T> pool;
+            for (size_t i = 0; i < 16; ++i)
+                pool.push_back(detail::random_value<T>(engine));
+            std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+            for (size_t i = 0; i < length; ++i)
+                values.push_back(pool[pick(engine)]);
+            return values;
+        }
+
+        for (size_t i = 0; i < length; ++i)
+            values.push_back(detail::random_value<T>(engine));
+
+        switch (input)
+        {
+        case distribution::sorted:
+            std::sort(values.begin(), values.end());
+            break;
+        case distribution::reversed:
+            std::sort(values.rbegin(), values.rend());
+            break;
+        case distribution::organ_pipe:
+            // ascending to the middle, descending after it
+            std::sort(values.begin(), values.end());
+            std::reverse(values.begin() + length / 2, values.end());
+            break;
+        default:
+            break;
+        }
+        return values;
+    }
+
+    struct benchmark_options
+    {
+        // runs before the measured ones, not recorded
+        size_t warmup = 1;
+        size_t trials = 5;
+        // samples outside [q1 - fence * iqr, q3 + fence * iqr] are dropped, 0 keeps everything
+        double outlier_fence = 1.5;
+    };
+
+    // times in microseconds, over the trials kept after outlier rejection
+    struct benchmark_stats
+    {
+        size_t trials = 0;
+        size_t kept = 0;
+        double median = 0;
+        double p95 = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    inline benchmark_stats summarize(std::vector<double> samples, double outlier_fence)
+    {
+        benchmark_stats stats;
+        stats.trials = samples.size();
+        if (samples.empty())
+            return stats;
+
+        std::sort(samples.begin(), samples.end());
+        auto quantile = [](const std::vector<double>& sorted, double q)
+        {
+            const double position = q * static_cast<double>(sorted.size() - 1);
+            const auto below = static_cast<size_t>(position);
+            const size_t above = std::min(below + 1, sorted.size() - 1);
+            return sorted[below] + (sorted[above] - sorted[below]) * (position - static_cast<double>(below));
+        };
+
+        // quartiles of a handful of samples say little, Tukey fences need a few of them
+        if (outlier_fence > 0 && samples.size() >= 4)
+        {
+            const double q1 = quantile(samples, 0.25), q3 = quantile(samples, 0.75);
+            const double low = q1 - outlier_fence * (q3 - q1), high = q3 + outlier_fence * (q3 - q1);
+            std::erase_if(samples, [&](double sample) { return sample < low || sample > high; });
+        }
+
+        stats.kept = samples.size();
+        stats.median = quantile(samples, 0.5);
+        // nearest rank
+        stats.p95 = samples[static_cast<size_t>(std::ceil(0.95 * static_cast<double>(samples.size()))) - 1];
+        stats.min = samples.front();
+        stats.max = samples.back();
+
+        double sum = 0;
+        for (double sample : samples)
+            sum += sample;
+        stats.mean = sum / static_cast<double>(samples.size());
+
+        double squares = 0;
+        for (double sample : samples)
+            squares += (sample - stats.mean) * (sample - stats.mean);
+        stats.stddev = samples.size() > 1 ? std::sqrt(squares / static_cast<double>(samples.size() - 1)) : 0.0;
+        return stats;
+    }
+
+    // setup() makes a fresh input for every run and is not timed, run(input) is
+    template<typename Setup, typename Run>
+    benchmark_stats measure(Setup setup, Run run, const benchmark_options& options = {})
+    {
+        using clock = std::chrono::steady_clock;
+        std::vector<double> samples;
+        samples.reserve(options.trials);
+
+        for (size_t i = 0; i < options.warmup + options.trials; ++i)
+        {
+            auto input = setup();
+            const auto start = clock::now();
+            run(input);
+            const auto time = clock::now() - start;
+            if (i >= options.warmup)
+                samples.push_back(std::chrono::duration<double, std::micro>(time).count());
+        }
+        return summarize(std::move(samples), options.outlier_fence);
+    }
+
+    struct benchmark_result
+    {
+        std::string name;
+        std::string container;
+        std::string type;
+        distribution input;
+        size_t length;
+        benchmark_stats stats;
+    };
+
+    enum class report_format { csv, json };
+
+    class benchmark_report
+    {
+        std::vector<benchmark_result> results_;
+
+        static std::string quoted(std::string_view text)
+        {
+            std::string result = "\"";
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                result += c;
+            }
+            return result + '"';
+        }
+
+    public:
+        void add(benchmark_result result)
+        {
+            results_.push_back(std::move(result));
+        }
+
+        [[nodiscard]] const std::vector<benchmark_result>& results() const noexcept
+        {
+            return results_;
+        }
+
+        void write_csv(std::ostream& output) const
+        {
+            output << "Name,Container,InnerType,Distribution,Elements,Trials,Kept,Median,P95,Mean,StdDev,Min,Max\n";
+            for (const auto& [name, container, type, input, length, stats] : results_)
+            {
+                output << name << ',' << container << ',' << type << ',' << to_string(input) << ',' << length << ','
+                    << stats.trials << ',' << stats.kept << ',' << stats.median << ',' << stats.p95 << ','
+                    << stats.mean << ',' << stats.stddev << ',' << stats.min << ',' << stats.max << '\n';
+            }
+        }
+
+        void write_json(std::ostream& output) const
+        {
+            output << "[\n";
+            for (size_t i = 0; i < results_.size(); ++i)
+            {
+                const auto& [name, container, type, input, length, stats] = results_[i];
+                output << "  {\"name\": " << quoted(name) << ", \"container\": " << quoted(container)
+                    << ", \"type\": " << quoted(type) << ", \"distribution\": " << quoted(to_string(input))
+                    << ", \"elements\": " << length << ", \"trials\": " << stats.trials << ", \"kept\": " << stats.kept
+                    << ", \"median\": " << stats.median << ", \"p95\": " << stats.p95 << ", \"mean\": " << stats.mean
+                    << ", \"stddev\": " << stats.stddev << ", \"min\": " << stats.min << ", \"max\": " << stats.max
+                    << (i + 1 < results_.size() ? "},\n" : "}\n");
+            }
+            output << "]\n";
+        }
+
+        void write(std::ostream& output, report_format format) const
+        {
+            if (format == report_format::json)
+                write_json(output);
+            else
+                write_csv(output);
+        }
+    };
+
+    // --output-dir DIR --format csv|json --warmup N --trials N --fence X --max-length N
+    struct benchmark_arguments
+    {
+        std::filesystem::path output_directory = ".";
+        report_format format = report_format::csv;
+        benchmark_options options;
+        size_t max_length = std::numeric_limits<size_t>::max();
+
+        static benchmark_arguments parse(int argc, const char* const* argv)
+        {
+            benchmark_arguments arguments;
+            for (int i = 1; i < argc; ++i)
+            {
+                const std::string_view flag = argv[i];
+                if (i + 1 == argc)
+                    throw std::invalid_argument("in benchmark_arguments flag " + std::string(flag) + " has no value");
+                const std::string value = argv[++i];
+
+                if (flag == "--output-dir")
+                    arguments.output_directory = value;
+                else if (flag == "--format" && (value == "csv" || value == "json"))
+                    arguments.format = value == "csv" ? report_format::csv : report_format::json;
+                else if (flag == "--warmup")
+                    arguments.options.warmup = std::stoul(value);
+                else if (flag == "--trials")
+                    arguments.options.trials = std::stoul(value);
+                else if (flag == "--fence")
+                    arguments.options.outlier_fence = std::stod(value);
+                else if (flag == "--max-length")
+                    arguments.max_length = std::stoul(value);
+                else
+                    throw std::invalid_argument("in benchmark_arguments unknown flag " + std::string(flag) + " " + value);
+            }
+            if (arguments.options.trials == 0)
+                throw std::invalid_argument("in benchmark_arguments --trials has to be positive");
+            return arguments;
+        }
+
+        // name with the extension of the format, inside the output directory
+        [[nodiscard]] std::filesystem::path path(const std::string& name) const
+        {
+            return output_directory / (name + (format == report_format::json ? ".json" : ".csv"));
+        }
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace testing
+{
+    // Global allocation statistics of every counting_allocator, not thread safe
+    struct allocation_counter
+    {
+        static inline size_t allocations = 0;
+        static inline size_t deallocations = 0;
+        static inline size_t bytes = 0;
+
+        static void reset() noexcept
+        { allocations = deallocations = bytes = 0; }
+    };
+
+
+    // std::allocator that reports to allocation_counter
+    template<typename T>
+    class counting_allocator
+    {
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        counting_allocator() noexcept = default;
+
+        template<typename U>
+        counting_allocator(const counting_allocator<U>&) noexcept { }
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            allocation_counter::allocations += 1;
+            allocation_counter::bytes += n * sizeof(T);
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* pointer, size_t n) noexcept
+        {
+            allocation_counter::deallocations += 1;
+            std::allocator<T>{}.deallocate(pointer, n);
+        }
+
+        template<typename U>
+        bool operator==(const counting_allocator<U>&) const noexcept
+        { return true; }
+    };
+}
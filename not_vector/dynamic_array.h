@@ -1,9 +1,137 @@
 #pragma once
+#include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include "utils.h"
 namespace collections
 {
+    // Capacity grows as capacity * Numerator / Denominator, 
+    // so appending is amortized O(1) for any ratio > 1
+    template<size_t Numerator = 2, size_t Denominator = 1>
+    requires (Denominator > 0 && Numerator > Denominator)
+    struct geometric_growth
+    {
+        [[nodiscard]] static constexpr size_t next_capacity(size_t capacity, size_t required) noexcept
+        {
+            const size_t grown = capacity + std::max(capacity * (Numerator - Denominator) / Denominator, size_t{1});
+            return std::max(grown, required);
+        }
+    };
+
+    template<typename Policy>
+    concept growth_policy = requires (size_t capacity, size_t required)
+    {
+        {Policy::next_capacity(capacity, required)} -> std::same_as<size_t>;
+    };
+
+    // Specialize for types whose objects may be moved to a new address with memcpy
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    namespace detail
+    {
+        // the length of the range is known before it is read (move_iterator is only an input iterator)
+        template<typename Iterator>
+        concept is_counted_iterator =
+            std::forward_iterator<Iterator> || std::sized_sentinel_for<Iterator, Iterator>;
+
+        template<typename T, typename InputIterator>
+        constexpr T* uninitialized_copy_n(InputIterator source, size_t n, T* destination)
+        {
+            T* current = destination;
+            try
+            {
+                for (; n > 0; --n, ++source, ++current)
+                { std::construct_at(current, *source); }
+            }
+            catch (...)
+            {
+                std::destroy(destination, current);
+                throw;
+            }
+            return current;
+        }
+
+        template<typename T, typename ...ArgsTy>
+        constexpr T* uninitialized_construct_n(T* destination, size_t n, const ArgsTy& ...args)
+        {
+            T* current = destination;
+            try
+            {
+                for (; n > 0; --n, ++current)
+                { std::construct_at(current, args...); }
+            }
+            catch (...)
+            {
+                std::destroy(destination, current);
+                throw;
+            }
+            return current;
+        }
+
+        // Moves when it can't throw (or copying is impossible), copies otherwise,
+        // so a throwing relocation leaves the source untouched
+        template<typename T>
+        constexpr T* uninitialized_move_if_noexcept(T* source, size_t n, T* destination)
+        {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                return uninitialized_copy_n(std::make_move_iterator(source), n, destination);
+            else
+                return uninitialized_copy_n(source, n, destination);
+        }
+
+        // Moves n objects to uninitialized destination and ends their lifetime in source
+        template<typename T>
+        constexpr void relocate(T* source, size_t n, T* destination)
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    if (n != 0)
+                        std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), n * sizeof(T));
+                    return;
+                }
+            }
+            uninitialized_move_if_noexcept(source, n, destination);
+            std::destroy_n(source, n);
+        }
+
+        // Relocates n objects leaving gap uninitialized slots after the first offset of them.
+        // On a throw destination holds nothing and source is untouched
+        template<typename T>
+        constexpr void relocate_with_gap(T* source, size_t n, size_t offset, size_t gap, T* destination)
+        {
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    relocate(source, offset, destination);
+                    relocate(source + offset, n - offset, destination + offset + gap);
+                    return;
+                }
+            }
+            uninitialized_move_if_noexcept(source, offset, destination);
+            try
+            { uninitialized_move_if_noexcept(source + offset, n - offset, destination + offset + gap); }
+            catch (...)
+            {
+                std::destroy_n(destination, offset);
+                throw;
+            }
+            std::destroy_n(source, n);
+        }
+    }
+
     template<typename T, bool Const>
     class dynamic_array_iterator
     {
@@ -28,6 +156,12 @@ namespace collections
             : current_element_(element)
         { }
 
+        template<bool OtherConst>
+        requires (Const && !OtherConst)
+        constexpr dynamic_array_iterator(const dynamic_array_iterator<T, OtherConst>& other) noexcept
+            : current_element_(other.current_element_)
+        { }
+
         constexpr dynamic_array_iterator& operator++() noexcept
         {
             ++current_element_;
@@ -78,6 +212,12 @@ namespace collections
             return (tmp -= offset);
         }
 
+        friend constexpr dynamic_array_iterator operator+(
+            const difference_type offset, const dynamic_array_iterator& it) noexcept
+        {
+            return it + offset;
+        }
+
         constexpr difference_type operator-(const dynamic_array_iterator& other) const noexcept
         {
             return (current_element_ - other.current_element_);
@@ -92,16 +232,33 @@ namespace collections
         constexpr pointer operator->() const noexcept
         { return current_element_; }
 
+        constexpr reference operator[](const difference_type offset) const noexcept
+        { return current_element_[offset]; }
+
     protected:
+        template<typename, bool>
+        friend class dynamic_array_iterator;
+
         pointer current_element_{nullptr};
     };
 
 
-    template<typename T>
+    template<
+        typename T,
+        typename Allocator = std::allocator<T>,
+        growth_policy GrowthPolicy = geometric_growth<>>
     class dynamic_array
     {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        static constexpr bool propagate_on_move = 
+            alloc_traits::propagate_on_container_move_assignment::value
+            || alloc_traits::is_always_equal::value;
+
     public:
         using value_type = T;
+        using allocator_type = Allocator;
+        using growth_policy_type = GrowthPolicy;
 
         using iterator = dynamic_array_iterator<value_type, false>;
         using const_iterator = dynamic_array_iterator<value_type, true>;
@@ -109,60 +266,120 @@ namespace collections
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
         constexpr dynamic_array() = default;
+
+        explicit constexpr dynamic_array(const allocator_type& allocator) noexcept
+            : allocator_(allocator) { }
+
         constexpr dynamic_array(const dynamic_array& other)
+            : dynamic_array(other, alloc_traits::select_on_container_copy_construction(other.allocator_)) { }
+
+        constexpr dynamic_array(const dynamic_array& other, const allocator_type& allocator)
+            : allocator_(allocator)
         {
-            resize(other.size());
-            std::copy_n(other.data_, size_, data_);
+            allocate(other.size_);
+            detail::uninitialized_copy_n(other.data_, other.size_, data_);
+            size_ = other.size_;
         }
 
         constexpr dynamic_array(dynamic_array&& other) noexcept
+            : allocator_(other.allocator_)
         {
-            *this = std::move(other);
+            steal(other);
         }
 
-        explicit constexpr dynamic_array(size_t n, value_type default_value = value_type{})
+        explicit constexpr dynamic_array(
+            size_t n, 
+            const value_type& default_value = value_type{},
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
-            resize(n);
-            std::fill(begin(), end(), default_value);
+            allocate(n);
+            detail::uninitialized_construct_n(data_, n, default_value);
+            size_ = n;
         }
 
-        constexpr dynamic_array(std::initializer_list<value_type> init_list)
+        constexpr dynamic_array(
+            std::initializer_list<value_type> init_list,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
-            resize(init_list.size());
-            std::copy_n(std::begin(init_list), size_, begin());
+            allocate(init_list.size());
+            detail::uninitialized_copy_n(std::begin(init_list), init_list.size(), data_);
+            size_ = init_list.size();
         }
 
         template<typename InputIterator>
         requires std::input_iterator<InputIterator>
-        constexpr dynamic_array(InputIterator begin_it, InputIterator end_it)
+        constexpr dynamic_array(
+            InputIterator begin_it, InputIterator end_it,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
-            resize(std::distance(begin_it, end_it));
-            std::copy_n(begin_it, size_, begin());
+            if constexpr (detail::is_counted_iterator<InputIterator>)
+            {
+                const size_t n = std::distance(begin_it, end_it);
+                allocate(n);
+                detail::uninitialized_copy_n(begin_it, n, data_);
+                size_ = n;
+            }
+            else
+            {
+                for (; begin_it != end_it; ++begin_it)
+                { emplace_back(*begin_it); }
+            }
         }
 
-        dynamic_array& operator=(const dynamic_array& other)
+        constexpr dynamic_array& operator=(const dynamic_array& other)
         {
             if (this == &other)
                 return *this;
-            dynamic_array tmp(other);
-            std::swap(data_, tmp.data_);
-            std::swap(size_, tmp.size_);
+
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+            {
+                dynamic_array tmp(other, other.allocator_);
+                swap_with_allocator(tmp);
+            }
+            else
+            {
+                dynamic_array tmp(other, allocator_);
+                swap_storage(tmp);
+            }
             return *this;
         }
 
-        dynamic_array& operator=(dynamic_array&& other) noexcept
+        constexpr dynamic_array& operator=(dynamic_array&& other) noexcept(propagate_on_move)
         {
             if (this == &other)
                 return *this;
 
-            data_ = other.data_;
-            size_ = other.size_;
-            other.data_ = nullptr;
-            other.size_ = 0;
-
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+            {
+                dynamic_array tmp(std::move(other));
+                swap_with_allocator(tmp);
+            }
+            else if (alloc_traits::is_always_equal::value || allocator_ == other.allocator_)
+            {
+                dynamic_array tmp(std::move(other));
+                swap_storage(tmp);
+            }
+            else
+            {
+                // storage of other can't be freed by our allocator, elements are moved one by one
+                dynamic_array tmp(
+                    std::make_move_iterator(other.begin()), 
+                    std::make_move_iterator(other.end()), 
+                    allocator_);
+                swap_storage(tmp);
+            }
             return *this;
         }
 
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+        { return allocator_; }
+
         constexpr value_type& operator[](size_t index)
         {
             if (index >= size_) 
@@ -189,22 +406,164 @@ namespace collections
         [[nodiscard]] constexpr size_t size() const noexcept
         { return size_; }
 
+        [[nodiscard]] constexpr size_t capacity() const noexcept
+        { return capacity_; }
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        { return size_ == 0; }
+
+        constexpr value_type* data() noexcept
+        { return data_; }
+
+        [[nodiscard]] constexpr const value_type* data() const noexcept
+        { return data_; }
+
+        constexpr void reserve(size_t new_capacity)
+        {
+            if (new_capacity > capacity_)
+                reallocate(new_capacity);
+        }
+
+        constexpr void shrink_to_fit()
+        {
+            if (capacity_ != size_)
+                reallocate(size_);
+        }
+
         constexpr void resize(size_t new_size)
         {
-            value_type* new_buff = nullptr;
-            if (new_size != 0)
-                new_buff = new value_type[new_size];
-            if (data_ != nullptr && size_ != 0) 
+            if (new_size > capacity_)
+                reallocate(GrowthPolicy::next_capacity(capacity_, new_size));
+            if (new_size > size_)
+                detail::uninitialized_construct_n(data_ + size_, new_size - size_);
+            else
+                std::destroy(data_ + new_size, data_ + size_);
+            size_ = new_size;
+        }
+
+        constexpr void push_back(const value_type& value)
+        { emplace_back(value); }
+
+        constexpr void push_back(value_type&& value)
+        { emplace_back(std::move(value)); }
+
+        template<class ...ArgsTy>
+        constexpr value_type& emplace_back(ArgsTy&& ...args)
+        {
+            if (size_ != capacity_)
             {
-                std::copy_n(data_, std::min(size_, new_size), new_buff);
-                delete[] data_;
+                std::construct_at(data_ + size_, std::forward<ArgsTy>(args)...);
+                return data_[size_++];
             }
-            size_ = new_size;
+
+            // args may alias an element, so the new value is built before relocating
+            const size_t new_capacity = GrowthPolicy::next_capacity(capacity_, size_ + 1);
+            value_type* new_buff = alloc_traits::allocate(allocator_, new_capacity);
+            try
+            { std::construct_at(new_buff + size_, std::forward<ArgsTy>(args)...); }
+            catch (...)
+            {
+                alloc_traits::deallocate(allocator_, new_buff, new_capacity);
+                throw;
+            }
+            try
+            { detail::relocate(data_, size_, new_buff); }
+            catch (...)
+            {
+                std::destroy_at(new_buff + size_);
+                release(new_buff, new_capacity);
+                throw;
+            }
+            release(data_, capacity_);
             data_ = new_buff;
+            capacity_ = new_capacity;
+            return data_[size_++];
+        }
+
+        // A single relocation pass: with enough capacity the new values are appended
+        // and rotated into place, otherwise everything goes straight to the new buffer
+        template<typename InputIterator>
+        requires std::input_iterator<InputIterator>
+        constexpr iterator insert(const_iterator position, InputIterator begin_it, InputIterator end_it)
+        {
+            if constexpr (!detail::is_counted_iterator<InputIterator>)
+            {
+                dynamic_array tmp(begin_it, end_it, allocator_);
+                return insert(position, std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+            }
+            else
+            {
+                const size_t offset = position - cbegin();
+                const size_t count = std::distance(begin_it, end_it);
+                if (size_ + count <= capacity_)
+                {
+                    detail::uninitialized_copy_n(begin_it, count, data_ + size_);
+                    size_ += count;
+                    std::rotate(data_ + offset, data_ + size_ - count, data_ + size_);
+                    return begin() + offset;
+                }
+
+                const size_t new_capacity = GrowthPolicy::next_capacity(capacity_, size_ + count);
+                value_type* new_buff = alloc_traits::allocate(allocator_, new_capacity);
+                try
+                { detail::uninitialized_copy_n(begin_it, count, new_buff + offset); }
+                catch (...)
+                {
+                    release(new_buff, new_capacity);
+                    throw;
+                }
+                try
+                { detail::relocate_with_gap(data_, size_, offset, count, new_buff); }
+                catch (...)
+                {
+                    std::destroy_n(new_buff + offset, count);
+                    release(new_buff, new_capacity);
+                    throw;
+                }
+                release(data_, capacity_);
+                data_ = new_buff;
+                size_ += count;
+                capacity_ = new_capacity;
+                return begin() + offset;
+            }
+        }
+
+        constexpr iterator erase(const_iterator begin_it, const_iterator end_it)
+        {
+            const size_t left = begin_it - cbegin();
+            const size_t right = end_it - cbegin();
+            // moving the tail onto itself would empty it for types like std::string
+            if (left == right)
+                return begin() + left;
+            std::move(data_ + right, data_ + size_, data_ + left);
+            std::destroy(data_ + size_ - (right - left), data_ + size_);
+            size_ -= right - left;
+            return begin() + left;
+        }
+
+        constexpr value_type pop_back()
+        {
+            if (size_ == 0)
+            { throw std::runtime_error("array size = 0"); }
+
+            size_ -= 1;
+            value_type tmp = std::move(data_[size_]);
+            std::destroy_at(data_ + size_);
+            return tmp;
         }
 
         constexpr void clear() noexcept
-        { resize(0); }
+        {
+            std::destroy(data_, data_ + size_);
+            size_ = 0;
+        }
+
+        constexpr void swap(dynamic_array& other) noexcept
+        {
+            if constexpr (alloc_traits::propagate_on_container_swap::value)
+                std::swap(allocator_, other.allocator_);
+            swap_storage(other);
+        }
 
         template<typename Container>
         requires std::ranges::range<Container>
@@ -249,15 +608,82 @@ namespace collections
         { return std::make_reverse_iterator(cbegin()); }
 
         constexpr ~dynamic_array()
-        { clear(); }
+        {
+            clear();
+            release(data_, capacity_);
+        }
 
     private:
+        constexpr void swap_storage(dynamic_array& other) noexcept
+        {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+        }
+
+        constexpr void swap_with_allocator(dynamic_array& other) noexcept
+        {
+            std::swap(allocator_, other.allocator_);
+            swap_storage(other);
+        }
+
+        constexpr void steal(dynamic_array& other) noexcept
+        {
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+
+        // Only for empty arrays, elements are constructed by the caller
+        constexpr void allocate(size_t capacity)
+        {
+            if (capacity != 0)
+                data_ = alloc_traits::allocate(allocator_, capacity);
+            capacity_ = capacity;
+        }
+
+        constexpr void release(value_type* buff, size_t capacity) noexcept
+        {
+            if (buff != nullptr)
+                alloc_traits::deallocate(allocator_, buff, capacity);
+        }
+
+        constexpr void reallocate(size_t new_capacity)
+        {
+            if (new_capacity < size_)
+            {
+                std::destroy(data_ + new_capacity, data_ + size_);
+                size_ = new_capacity;
+            }
+            value_type* new_buff = nullptr;
+            if (new_capacity != 0)
+                new_buff = alloc_traits::allocate(allocator_, new_capacity);
+            try
+            { detail::relocate(data_, size_, new_buff); }
+            catch (...)
+            {
+                release(new_buff, new_capacity);
+                throw;
+            }
+            release(data_, capacity_);
+            data_ = new_buff;
+            capacity_ = new_capacity;
+        }
+
+        [[no_unique_address]] allocator_type allocator_{};
         value_type* data_ = nullptr;
         size_t size_ = size_t{0};
+        size_t capacity_ = size_t{0};
     };
 
     template<typename InputIterator>
     requires std::input_iterator<InputIterator>
     dynamic_array(InputIterator begin_it, InputIterator end_it)
     -> dynamic_array<typename std::iterator_traits<InputIterator>::value_type>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using dynamic_array = collections::dynamic_array<T, std::pmr::polymorphic_allocator<T>>;
+    }
 }
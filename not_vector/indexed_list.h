@@ -0,0 +1,685 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "utils.h"
+
+namespace collections
+{
+    template<typename T>
+    struct indexed_list_node
+    {
+        struct link
+        {
+            indexed_list_node* next = nullptr;
+            // distance in elements to next, or to the position after the last element
+            size_t width = 0;
+        };
+
+        T value;
+        indexed_list_node* previous = nullptr;
+        link* tower = nullptr;
+        size_t height = 0;
+    };
+
+
+    template<typename T, typename Allocator>
+    class indexed_list;
+
+    template<typename T, bool Const>
+    class indexed_list_iterator
+    {
+        using node_type = indexed_list_node<T>;
+
+    public:
+        using value_type        = T;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type   = ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+
+        constexpr indexed_list_iterator() noexcept = default;
+
+        constexpr indexed_list_iterator(node_type* node, node_type* const* tail) noexcept
+            : node_(node), tail_(tail) { }
+
+        template<bool OtherConst>
+        requires (Const && !OtherConst)
+        constexpr indexed_list_iterator(const indexed_list_iterator<T, OtherConst>& other) noexcept
+            : node_(other.node_), tail_(other.tail_) { }
+
+        indexed_list_iterator& operator++() noexcept
+        {
+            node_ = node_->tower[0].next;
+            return *this;
+        }
+
+        indexed_list_iterator operator++(int) noexcept
+        {
+            auto tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        indexed_list_iterator& operator--() noexcept
+        {
+            node_ = node_ != nullptr ? node_->previous : *tail_;
+            return *this;
+        }
+
+        indexed_list_iterator operator--(int) noexcept
+        {
+            auto tmp(*this);
+            --(*this);
+            return tmp;
+        }
+
+        constexpr bool operator==(const indexed_list_iterator& other) const noexcept
+        { return node_ == other.node_; }
+
+        reference operator*() const noexcept
+        { return node_->value; }
+
+        pointer operator->() const noexcept
+        { return &node_->value; }
+
+    private:
+        template<typename, bool>
+        friend class indexed_list_iterator;
+
+        template<typename, typename>
+        friend class indexed_list;
+
+        node_type* node_ = nullptr;
+        node_type* const* tail_ = nullptr;
+    };
+
+
+    // Doubly linked list with an indexable skip list on top of it:
+    // positional access, insert, erase, cut and concat are O(log n) expected,
+    // iteration stays a plain pointer walk
+    template<typename T, typename Allocator = std::allocator<T>>
+    class indexed_list
+    {
+        using node_type = indexed_list_node<T>;
+        using link = typename node_type::link;
+        using node_allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+        using link_allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<link>;
+        using node_traits = std::allocator_traits<node_allocator_type>;
+        using link_traits = std::allocator_traits<link_allocator_type>;
+
+        static constexpr size_t max_level = 32;
+
+        // predecessors of a position on every level
+        struct search_path
+        {
+            std::array<link*, max_level> towers;
+            std::array<size_t, max_level> positions;
+            node_type* previous;
+        };
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using iterator = indexed_list_iterator<value_type, false>;
+        using const_iterator = indexed_list_iterator<value_type, true>;
+
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        indexed_list() noexcept
+        { reset_head(); }
+
+        explicit indexed_list(const allocator_type& allocator) noexcept
+            : allocator_(allocator)
+        { reset_head(); }
+
+        explicit indexed_list(
+            size_t count,
+            const value_type& default_value = {},
+            const allocator_type& allocator = allocator_type{}
+        )
+            : indexed_list(allocator)
+        {
+            for (; count > 0; --count)
+            { emplace_back(default_value); }
+        }
+
+        template<typename IteratorType>
+        requires std::input_iterator<IteratorType>
+        indexed_list(
+            IteratorType begin_it, IteratorType end_it,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : indexed_list(allocator)
+        {
+            for (; begin_it != end_it; ++begin_it)
+            { emplace_back(*begin_it); }
+        }
+
+        indexed_list(
+            std::initializer_list<value_type> list,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : indexed_list(allocator)
+        {
+            for (const auto& i : list)
+            { emplace_back(i); }
+        }
+
+        indexed_list(const indexed_list& other)
+            : indexed_list(node_traits::select_on_container_copy_construction(other.allocator_))
+        { append_copy(other); }
+
+        indexed_list(indexed_list&& other) noexcept
+            : allocator_(other.allocator_)
+        {
+            reset_head();
+            steal(other);
+        }
+
+        indexed_list& operator=(const indexed_list& other)
+        {
+            if (this != &other)
+            {
+                indexed_list tmp(std::move(*this));
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                    allocator_ = other.allocator_;
+                append_copy(other);
+            }
+            return *this;
+        }
+
+        indexed_list& operator=(indexed_list&& other)
+            noexcept(node_traits::propagate_on_container_move_assignment::value
+                || node_traits::is_always_equal::value)
+        {
+            if (this != &other)
+            {
+                indexed_list tmp(std::move(*this));
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    allocator_ = other.allocator_;
+                    steal(other);
+                }
+                else if (node_traits::is_always_equal::value || allocator_ == other.allocator_)
+                { steal(other); }
+                else
+                {
+                    for (auto& value : other)
+                    { emplace_back(std::move(value)); }
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        ~indexed_list() noexcept
+        { clear(); }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept
+        { return allocator_type(allocator_); }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return size_; }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return size_ == 0; }
+
+        value_type& operator[](const size_t index)
+        { return node_by_index(index)->value; }
+
+        const value_type& operator[](const size_t index) const
+        { return node_by_index(index)->value; }
+
+        value_type& at(const size_t index)
+        { return node_by_index(index)->value; }
+
+        const value_type& at(const size_t index) const
+        { return node_by_index(index)->value; }
+
+        // O(log n) expected, index == size() gives end()
+        iterator iterator_at(const size_t index)
+        { return iterator{index == size_ ? nullptr : node_by_index(index), &tail_}; }
+
+        [[nodiscard]] const_iterator iterator_at(const size_t index) const
+        { return const_iterator{index == size_ ? nullptr : node_by_index(index), &tail_}; }
+
+        iterator push_back(const value_type& value)
+        { return emplace(size_, value); }
+
+        iterator push_back(value_type&& value)
+        { return emplace(size_, std::move(value)); }
+
+        iterator push_front(const value_type& value)
+        { return emplace(0, value); }
+
+        iterator push_front(value_type&& value)
+        { return emplace(0, std::move(value)); }
+
+        iterator insert(const size_t index, const value_type& value)
+        { return emplace(index, value); }
+
+        iterator insert(const size_t index, value_type&& value)
+        { return emplace(index, std::move(value)); }
+
+        template<class ...ArgsTy>
+        iterator emplace_back(ArgsTy&& ...args)
+        { return emplace(size_, std::forward<ArgsTy>(args)...); }
+
+        template<class ...ArgsTy>
+        iterator emplace_front(ArgsTy&& ...args)
+        { return emplace(0, std::forward<ArgsTy>(args)...); }
+
+        template<class ...ArgsTy>
+        iterator emplace(const size_t index, ArgsTy&& ...args)
+        {
+            if (index > size_)
+                throw_out_of_range(index);
+
+            node_type* node = create_node(random_height(), std::forward<ArgsTy>(args)...);
+            if (node->height > level_)
+            {
+                for (size_t l = level_; l < node->height; ++l)
+                { head_[l] = link{nullptr, size_ + 1}; }
+                level_ = node->height;
+            }
+
+            search_path path = find(index);
+            const size_t position = index + 1;
+            for (size_t l = 0; l < level_; ++l)
+            {
+                link& before = path.towers[l][l];
+                if (l < node->height)
+                {
+                    node->tower[l] = link{before.next, path.positions[l] + before.width + 1 - position};
+                    before = link{node, position - path.positions[l]};
+                }
+                else
+                { before.width += 1; }
+            }
+
+            node->previous = path.previous;
+            if (node->tower[0].next != nullptr)
+                node->tower[0].next->previous = node;
+            else
+                tail_ = node;
+            size_ += 1;
+            return iterator(node, &tail_);
+        }
+
+        template<class ...ArgsTy>
+        iterator emplace(const_iterator position, ArgsTy&& ...args)
+        { return emplace(index_of(position.node_), std::forward<ArgsTy>(args)...); }
+
+        value_type pop_back()
+        {
+            if (size_ == 0)
+            { throw std::runtime_error("list size = 0"); }
+            return extract(size_ - 1);
+        }
+
+        value_type pop_front()
+        {
+            if (size_ == 0)
+            { throw std::runtime_error("list size = 0"); }
+            return extract(0);
+        }
+
+        value_type extract(const size_t index)
+        {
+            node_type* node = unlink(index);
+            value_type tmp = std::move(node->value);
+            destroy_node(node);
+            return tmp;
+        }
+
+        iterator erase(const_iterator position)
+        {
+            if (position == cend()) throw std::invalid_argument("index = cend()");
+            return erase(index_of(position.node_));
+        }
+
+        iterator erase(const_iterator left_it, const_iterator right_it)
+        {
+            if (left_it == right_it)
+                return iterator(left_it.node_, &tail_);
+            const size_t left = index_of(left_it.node_);
+            const size_t right = right_it == cend() ? size_ : index_of(right_it.node_);
+            return erase(left, right);
+        }
+
+        iterator erase(size_t index)
+        {
+            node_type* node = unlink(index);
+            node_type* next = node->tower[0].next;
+            destroy_node(node);
+            return iterator(next, &tail_);
+        }
+
+        iterator erase(size_t left_index, size_t right_index)
+        {
+            if (left_index > right_index || right_index > size_)
+                throw std::out_of_range("indexed_list erase range out of range");
+
+            auto [left, tail] = cut(left_index);
+            auto [middle, right] = tail.cut(right_index - left_index);
+            node_type* next = right.head_[0].next;
+            left.concat(std::move(right));
+            *this = std::move(left);
+            return iterator(next, &tail_);
+        }
+
+        // O(log n) expected, the towers of both lists are stitched level by level
+        void concat(indexed_list other)
+        {
+            if (!node_traits::is_always_equal::value && !(allocator_ == other.allocator_))
+            {
+                for (auto& value : other)
+                { emplace_back(std::move(value)); }
+                return;
+            }
+            if (other.size_ == 0)
+                return;
+
+            const size_t levels = std::max(level_, other.level_);
+            for (size_t l = level_; l < levels; ++l)
+            { head_[l] = link{nullptr, size_ + 1}; }
+            for (size_t l = other.level_; l < levels; ++l)
+            { other.head_[l] = link{nullptr, other.size_ + 1}; }
+
+            link* tower = head_.data();
+            size_t position = 0;
+            for (size_t l = levels; l-- > 0;)
+            {
+                while (tower[l].next != nullptr)
+                {
+                    position += tower[l].width;
+                    tower = tower[l].next->tower;
+                }
+                tower[l] = link{other.head_[l].next, size_ + other.head_[l].width - position};
+            }
+
+            other.head_[0].next->previous = tail_;
+            tail_ = other.tail_;
+            size_ += other.size_;
+            level_ = levels;
+            other.reset_head();
+        }
+
+        std::pair<indexed_list, indexed_list> cut(iterator edge)
+        {
+            return cut(edge == end() ? size_ : index_of(edge.node_));
+        }
+
+        std::pair<indexed_list, indexed_list> cut(size_t index)
+        {
+            if (index > size_)
+                throw_out_of_range(index);
+
+            indexed_list right(get_allocator());
+            search_path path = find(index);
+            for (size_t l = 0; l < level_; ++l)
+            {
+                link& before = path.towers[l][l];
+                right.head_[l] = link{before.next, path.positions[l] + before.width - index};
+                before = link{nullptr, index + 1 - path.positions[l]};
+            }
+            right.level_ = level_;
+            right.size_ = size_ - index;
+            if (right.size_ != 0)
+            {
+                right.head_[0].next->previous = nullptr;
+                right.tail_ = tail_;
+            }
+            tail_ = path.previous;
+            size_ = index;
+
+            indexed_list left(std::move(*this));
+            return {std::move(left), std::move(right)};
+        }
+
+        iterator begin() noexcept
+        { return iterator{head_[0].next, &tail_}; }
+        iterator end() noexcept
+        { return iterator{nullptr, &tail_}; }
+
+        [[nodiscard]] const_iterator begin() const noexcept
+        { return const_iterator{head_[0].next, &tail_}; }
+        [[nodiscard]] const_iterator end() const noexcept
+        { return const_iterator{nullptr, &tail_}; }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept
+        { return begin(); }
+        [[nodiscard]] const_iterator cend() const noexcept
+        { return end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return std::make_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return std::make_reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const noexcept
+        { return std::make_reverse_iterator(end()); }
+        [[nodiscard]] const_reverse_iterator rend() const noexcept
+        { return std::make_reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rcbegin() const noexcept
+        { return std::make_reverse_iterator(cend()); }
+        [[nodiscard]] const_reverse_iterator rcend() const noexcept
+        { return std::make_reverse_iterator(cbegin()); }
+
+        void swap(indexed_list& other) noexcept
+        {
+            indexed_list tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        void clear() noexcept
+        {
+            node_type* node = head_[0].next;
+            while (node != nullptr)
+            {
+                node_type* next = node->tower[0].next;
+                destroy_node(node);
+                node = next;
+            }
+            reset_head();
+        }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        auto operator<=>(const Container& container) const noexcept
+        { return compare_collections(*this, container); }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        bool operator==(const Container& container) const noexcept
+        { return is_equal_collections(*this, container); }
+
+    private:
+        [[noreturn]] void throw_out_of_range(size_t index) const
+        {
+            throw std::out_of_range(
+                "in indexed_list index out of range (index) "
+                + std::to_string(index) + " > (size) " + std::to_string(size_));
+        }
+
+        // last node before index on every level, the head when there is none
+        search_path find(size_t index) noexcept
+        {
+            search_path path;
+            link* tower = head_.data();
+            node_type* node = nullptr;
+            size_t position = 0;
+            for (size_t l = level_; l-- > 0;)
+            {
+                while (tower[l].next != nullptr && position + tower[l].width <= index)
+                {
+                    position += tower[l].width;
+                    node = tower[l].next;
+                    tower = node->tower;
+                }
+                path.towers[l] = tower;
+                path.positions[l] = position;
+            }
+            path.previous = node;
+            return path;
+        }
+
+        [[nodiscard]] node_type* node_by_index(size_t index) const
+        {
+            if (index >= size_)
+                throw_out_of_range(index);
+
+            const link* tower = head_.data();
+            node_type* node = nullptr;
+            size_t position = 0;
+            for (size_t l = level_; l-- > 0;)
+            {
+                while (tower[l].next != nullptr && position + tower[l].width <= index + 1)
+                {
+                    position += tower[l].width;
+                    node = tower[l].next;
+                    tower = node->tower;
+                }
+                if (position == index + 1)
+                    break;
+            }
+            return node;
+        }
+
+        // walks to the end on the highest links, so O(log n) expected
+        [[nodiscard]] size_t index_of(const node_type* node) const noexcept
+        {
+            if (node == nullptr)
+                return size_;
+            size_t to_end = 0;
+            for (const node_type* current = node; current != nullptr;)
+            {
+                const link& top = current->tower[current->height - 1];
+                to_end += top.width;
+                current = top.next;
+            }
+            return size_ - to_end;
+        }
+
+        node_type* unlink(size_t index)
+        {
+            if (index >= size_)
+                throw_out_of_range(index);
+
+            search_path path = find(index);
+            node_type* node = path.towers[0][0].next;
+            for (size_t l = 0; l < level_; ++l)
+            {
+                link& before = path.towers[l][l];
+                if (before.next == node)
+                    before = link{node->tower[l].next, before.width + node->tower[l].width - 1};
+                else
+                    before.width -= 1;
+            }
+
+            if (node->tower[0].next != nullptr)
+                node->tower[0].next->previous = node->previous;
+            else
+                tail_ = node->previous;
+            size_ -= 1;
+            return node;
+        }
+
+        size_t random_height() noexcept
+        {
+            // xorshift64, every level is kept with probability 1/4
+            random_state_ ^= random_state_ << 13;
+            random_state_ ^= random_state_ >> 7;
+            random_state_ ^= random_state_ << 17;
+            const size_t height = 1 + std::countr_zero(random_state_ | (std::uint64_t{1} << 62)) / 2;
+            return std::min(height, max_level);
+        }
+
+        template<class ...ArgsTy>
+        node_type* create_node(size_t height, ArgsTy&& ...args)
+        {
+            link_allocator_type link_allocator(allocator_);
+            link* tower = link_traits::allocate(link_allocator, height);
+            node_type* node;
+            try
+            { node = node_traits::allocate(allocator_, 1); }
+            catch (...)
+            {
+                link_traits::deallocate(link_allocator, tower, height);
+                throw;
+            }
+            try
+            { std::construct_at(node, value_type{std::forward<ArgsTy>(args) ...}, nullptr, tower, height); }
+            catch (...)
+            {
+                node_traits::deallocate(allocator_, node, 1);
+                link_traits::deallocate(link_allocator, tower, height);
+                throw;
+            }
+            std::uninitialized_value_construct_n(tower, height);
+            return node;
+        }
+
+        void destroy_node(node_type* node) noexcept
+        {
+            link_allocator_type link_allocator(allocator_);
+            link_traits::deallocate(link_allocator, node->tower, node->height);
+            std::destroy_at(node);
+            node_traits::deallocate(allocator_, node, 1);
+        }
+
+        void reset_head() noexcept
+        {
+            head_[0] = link{nullptr, 1};
+            tail_ = nullptr;
+            size_ = 0;
+            level_ = 1;
+        }
+
+        void append_copy(const indexed_list& other)
+        {
+            for (const auto& value : other)
+            { emplace_back(value); }
+        }
+
+        void steal(indexed_list& other) noexcept
+        {
+            head_ = other.head_;
+            tail_ = other.tail_;
+            size_ = other.size_;
+            level_ = other.level_;
+            other.reset_head();
+        }
+
+        [[no_unique_address]] node_allocator_type allocator_{};
+        std::array<link, max_level> head_{};
+        node_type* tail_ = nullptr;
+        size_t size_ = 0;
+        size_t level_ = 1;
+        std::uint64_t random_state_ = 0x9E3779B97F4A7C15ull;
+    };
+
+    template<typename IteratorType>
+    indexed_list(IteratorType, IteratorType)
+    -> indexed_list<typename std::iterator_traits<IteratorType>::value_type>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using indexed_list = collections::indexed_list<T, std::pmr::polymorphic_allocator<T>>;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "indexed_list.h"
+
+
+namespace collections
+{
+    namespace sequence_companion
+    {
+        template <typename T, typename Allocator>
+        void concat_containers_mut(indexed_list<T, Allocator>& lhs, indexed_list<T, Allocator> rhs)
+        {
+            lhs.concat(std::move(rhs));
+        }
+
+        template<typename T, typename Allocator>
+        std::pair<indexed_list<T, Allocator>, indexed_list<T, Allocator>> cut_container_mut
+        (typename indexed_list<T, Allocator>::iterator index, indexed_list<T, Allocator>& cont)
+        {
+            return cont.cut(index);
+        }
+    }
+}
+
+#include "sequence.h"
+
+namespace collections
+{
+
+    template<typename T, typename Allocator = std::allocator<T>>
+    using indexed_sequence = collections::sequence<indexed_list<T, Allocator>>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using indexed_sequence = collections::indexed_sequence<T, std::pmr::polymorphic_allocator<T>>;
+    }
+}
@@ -2,19 +2,23 @@
 
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <array>
 #include <iterator>
 #include <ranges>
 #include <concepts>
 
+#include "node_pool.h"
 #include "utils.h"
 
 namespace collections
 {
-    template<typename ValueType>
+    template<typename ValueType, typename Allocator = std::allocator<ValueType>>
     class linked_list;
 
     template<typename ValueType>
@@ -22,7 +26,8 @@ namespace collections
     {
     private:
 
-        friend linked_list<ValueType>;
+        template<typename, typename>
+        friend class linked_list;
 
         constexpr void linkage() noexcept
         {
@@ -184,27 +189,43 @@ namespace collections
         { return &current_node_->value; }
 
     private:
-        friend linked_list<T>;
+        template<typename, typename>
+        friend class linked_list;
         linked_list_node<T>* current_node_ = nullptr;
         bool list_edge_ = false;
     };
 
 
-    template<typename T>
+    template<typename T, typename Allocator>
     class linked_list
     {
+        using node_type = linked_list_node<T>;
+        using node_allocator_type = 
+            typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
     public:
         using value_type = T;
+        using allocator_type = Allocator;
         using iterator = node_iterator_impl<value_type, false>;
         using const_iterator = node_iterator_impl<value_type, true>;
 
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-        constexpr linked_list() noexcept = default;
+        // a pool_allocator makes its pool here, which may throw
+        constexpr linked_list() noexcept(std::is_nothrow_default_constructible_v<node_allocator_type>) = default;
+
+        explicit constexpr linked_list(const allocator_type& allocator) noexcept
+            : allocator_(allocator) { }
 
         explicit constexpr
-        linked_list(size_t count, const value_type& default_value = {})
+        linked_list(
+            size_t count, 
+            const value_type& default_value = {},
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
             for(;count > 0; --count)
             { emplace_back(default_value); }
@@ -212,7 +233,11 @@ namespace collections
     
         template<typename IteratorType>
         requires std::input_iterator<IteratorType>
-        constexpr linked_list(IteratorType begin_it, IteratorType end_it)
+        constexpr linked_list(
+            IteratorType begin_it, IteratorType end_it,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
             while (begin_it != end_it)
             {
@@ -221,49 +246,68 @@ namespace collections
             }
         }
 
-        constexpr linked_list(std::initializer_list<value_type> list)
+        constexpr linked_list(
+            std::initializer_list<value_type> list,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
         {
             for (const auto& i : list)
             { emplace_back(i); }
         }
 
         constexpr linked_list(const linked_list& other)
-        { *this = other; }
+            : allocator_(node_traits::select_on_container_copy_construction(other.allocator_))
+        { append_copy(other); }
+
+        constexpr linked_list(const linked_list& other, const allocator_type& allocator)
+            : allocator_(allocator)
+        { append_copy(other); }
     
         constexpr linked_list(linked_list&& other) noexcept
-        { *this = std::move(other); }
+            : allocator_(other.allocator_)
+        { steal(other); }
 
         constexpr linked_list& operator=(const linked_list& other)
         {
             if (this != &other)
             {
                 linked_list tmp(std::move(*this));
-                linked_list_node<value_type>* node = other.head_;
-                while (node != nullptr)
-                {
-                    emplace_back(node->value);
-                    node = node->next;
-                }
+                if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                    allocator_ = other.allocator_;
+                append_copy(other);
             }
             return *this;
         }
 
-        constexpr linked_list& operator=(linked_list&& other) noexcept
+        constexpr linked_list& operator=(linked_list&& other) 
+            noexcept(node_traits::propagate_on_container_move_assignment::value
+                || node_traits::is_always_equal::value)
         {
             if(this != &other)
             {
-                linked_list tmp;
-                std::swap(head_ , tmp.head_);
-                std::swap(tail_ , tmp.tail_);
-                std::swap(size_ , tmp.size_);
-                std::swap(head_ , other.head_);
-                std::swap(tail_ , other.tail_);
-                std::swap(size_ , other.size_);
-
+                linked_list tmp(std::move(*this));
+                if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                {
+                    allocator_ = other.allocator_;
+                    steal(other);
+                }
+                else if (node_traits::is_always_equal::value || allocator_ == other.allocator_)
+                { steal(other); }
+                else
+                {
+                    // nodes of other can't be freed by our allocator, values are moved one by one
+                    for (auto& value : other)
+                    { emplace_back(std::move(value)); }
+                    other.clear();
+                }
             }
             return *this;
         }
 
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+        { return allocator_type(allocator_); }
+
         [[nodiscard]] constexpr size_t size() const noexcept
         { return size_; }
 
@@ -304,7 +348,7 @@ namespace collections
 
             value_type tmp = std::move(tail_->value);
             auto* tmp_node = tail_->previous;
-            delete tail_;
+            destroy_node(tail_);
             tail_ = tmp_node;
             size_ -=1;
             return tmp;
@@ -317,7 +361,7 @@ namespace collections
 
             value_type tmp = std::move(head_->value);
             auto* tmp_node = head_->next;
-            delete head_;
+            destroy_node(head_);
             head_ = tmp_node;
             size_ -= 1;
             return tmp;
@@ -327,15 +371,14 @@ namespace collections
         {
             linked_list_node<value_type>* node = node_by_index(index);
             value_type tmp = std::move(node->value);
-            delete node;
+            destroy_node(node);
             return std::move(tmp);
         }
 
         template<class ...ArgsTy>
         constexpr iterator emplace_back(ArgsTy&& ...args)
         {
-            tail_ = new linked_list_node<value_type>
-{ value_type{std::forward<ArgsTy>(args) ...}, nullptr, tail_ };
+            tail_ = create_node(nullptr, tail_, std::forward<ArgsTy>(args)...);
 
             if (size_ == 0) { head_ = tail_; }
             size_ += 1;
@@ -345,8 +388,7 @@ namespace collections
         template<class ...ArgsTy>
         constexpr iterator emplace_front(ArgsTy&& ...args)
         {
-            head_ = new linked_list_node<value_type>
-{ value_type{std::forward<ArgsTy>(args) ...}, head_ };
+            head_ = create_node(head_, nullptr, std::forward<ArgsTy>(args)...);
 
             if (size_ == 0) { tail_ = head_; }
             size_ += 1;
@@ -357,8 +399,7 @@ namespace collections
         constexpr iterator emplace(const size_t index, ArgsTy&& ...args)
         {
             linked_list_node<value_type>* in_index = node_by_index(index);
-            auto tmp = new linked_list_node<value_type>
-{ value_type{std::forward<ArgsTy>(args) ...}, in_index, in_index->previous };
+            auto tmp = create_node(in_index, in_index->previous, std::forward<ArgsTy>(args)...);
             size_ += 1;
             return iterator(tmp);
         }
@@ -366,6 +407,13 @@ namespace collections
 
         constexpr void concat(linked_list other)
         {
+            if (!node_traits::is_always_equal::value && !(allocator_ == other.allocator_))
+            {
+                for (auto& value : other)
+                { emplace_back(std::move(value)); }
+                return;
+            }
+
             if (tail_ != nullptr)
                 linked_list_node<value_type> tmp({}, other.head_, this->tail_);
             else
@@ -377,11 +425,100 @@ namespace collections
             other.size_ = 0;
         }
 
+        // stable, relinks nodes and never moves values
+        template<typename Comparator = std::less<value_type>>
+        constexpr void merge(linked_list& other, Comparator cmp = Comparator{})
+        {
+            if (this == &other || other.size_ == 0)
+                return;
+
+            if (!node_traits::is_always_equal::value && !(allocator_ == other.allocator_))
+            {
+                linked_list tmp(get_allocator());
+                for (auto& value : other)
+                { tmp.emplace_back(std::move(value)); }
+                other.clear();
+                merge(tmp, std::move(cmp));
+                return;
+            }
+
+            // a throwing cmp leaves every node of both lists in this one
+            node_type* merged;
+            try
+            { merged = merge_chains(head_, other.head_, cmp); }
+            catch (...)
+            {
+                relink(head_);
+                size_ += other.size_;
+                other.head_ = other.tail_ = nullptr;
+                other.size_ = 0;
+                throw;
+            }
+            relink(merged);
+            size_ += other.size_;
+            other.head_ = other.tail_ = nullptr;
+            other.size_ = 0;
+        }
+
+        template<typename Comparator = std::less<value_type>>
+        constexpr void merge(linked_list&& other, Comparator cmp = Comparator{})
+        { merge(other, std::move(cmp)); }
+
+        // Stable natural merge sort without recursion: runs are merged in binary counter
+        // fashion, bins[i] holds about 2^i of them. Iterators to elements stay valid.
+        // If cmp throws, the list keeps all of its nodes in an unspecified order.
+        template<typename Comparator = std::less<value_type>>
+        constexpr void sort(Comparator cmp = Comparator{})
+        {
+            if (size_ < 2)
+                return;
+
+            node_type* bins[64] = {};
+            size_t used = 0;
+            node_type* rest = head_;
+            node_type* carry = nullptr;
+            node_type* sorted = nullptr;
+
+            try
+            {
+                while (rest != nullptr)
+                {
+                    carry = take_run(rest, cmp);
+                    size_t i = 0;
+                    for (; i < used && bins[i] != nullptr; ++i)
+                    {
+                        carry = merge_chains(bins[i], carry, cmp);
+                        bins[i] = nullptr;
+                    }
+                    bins[i] = std::exchange(carry, nullptr);
+                    if (i == used)
+                        ++used;
+                }
+
+                for (size_t i = 0; i < used; ++i)
+                {
+                    if (bins[i] != nullptr)
+                        sorted = merge_chains(bins[i], sorted, cmp);
+                    bins[i] = nullptr;
+                }
+            }
+            catch (...)
+            {
+                node_type* all = append_chain(carry, rest);
+                all = append_chain(sorted, all);
+                for (size_t i = 0; i < used; ++i)
+                { all = append_chain(bins[i], all); }
+                relink(all);
+                throw;
+            }
+            relink(sorted);
+        }
+
         constexpr iterator erase(const_iterator index)
         {
             if (index == cend()) throw std::invalid_argument("index = cend()");
             iterator res(index.current_node_->next, index.current_node_->next == tail_->previous);
-            delete index.current_node_;
+            destroy_node(index.current_node_);
             --size_;
             return res;
         }
@@ -391,7 +528,7 @@ namespace collections
             while(left_it != right_it)
             {
                 ++left_it;
-                delete left_it.current_node_->previous;
+                destroy_node(left_it.current_node_->previous);
             }
             return iterator(left_it.current_node_, left_it.list_edge_);
         }
@@ -415,7 +552,7 @@ namespace collections
     private: constexpr std::pair<linked_list, linked_list>
         cut(linked_list_node<value_type>* edge, const size_t index)
     {
-        linked_list right;
+        linked_list right(get_allocator());
         right.head_ = edge;
         right.tail_ = tail_;
         right.size_ = size_ - index;
@@ -433,7 +570,7 @@ namespace collections
 
         linked_list left(std::move(*this));
 
-        return {std::move(left), (right)};
+        return {std::move(left), std::move(right)};
     }
 
     public:
@@ -511,6 +648,140 @@ namespace collections
         { clear(); }
 
     private:
+        template<class ...ArgsTy>
+        constexpr node_type* create_node(node_type* next, node_type* previous, ArgsTy&& ...args)
+        {
+            node_type* node = node_traits::allocate(allocator_, 1);
+            try
+            { std::construct_at(node, value_type{std::forward<ArgsTy>(args) ...}, next, previous); }
+            catch (...)
+            {
+                node_traits::deallocate(allocator_, node, 1);
+                throw;
+            }
+            return node;
+        }
+
+        constexpr void destroy_node(node_type* node) noexcept
+        {
+            std::destroy_at(node);
+            node_traits::deallocate(allocator_, node, 1);
+        }
+
+        // Chains below are linked through next only and end with nullptr,
+        // relink restores previous and tail_ afterwards.
+        static constexpr node_type* append_chain(node_type* head, node_type* tail) noexcept
+        {
+            if (head == nullptr)
+                return tail;
+            node_type* last = head;
+            while (last->next != nullptr)
+            { last = last->next; }
+            last->next = tail;
+            return head;
+        }
+
+        // If cmp throws, left_chain gets the nodes of both chains and right_chain is emptied
+        template<typename Comparator>
+        static constexpr node_type* merge_chains(node_type*& left_chain, node_type*& right_chain, Comparator& cmp)
+        {
+            node_type* left = left_chain;
+            node_type* right = right_chain;
+            node_type* head = nullptr;
+            node_type** link = &head;
+            try
+            {
+                while (left != nullptr && right != nullptr)
+                {
+                    if (cmp(right->value, left->value))
+                    {
+                        *link = right;
+                        right = right->next;
+                    }
+                    else
+                    {
+                        *link = left;
+                        left = left->next;
+                    }
+                    link = &(*link)->next;
+                }
+            }
+            catch (...)
+            {
+                *link = append_chain(left, right);
+                left_chain = head;
+                right_chain = nullptr;
+                throw;
+            }
+            *link = left != nullptr ? left : right;
+            return head;
+        }
+
+        // detaches the longest sorted prefix of rest, a strictly descending one is reversed
+        template<typename Comparator>
+        static constexpr node_type* take_run(node_type*& rest, Comparator& cmp)
+        {
+            node_type* head = rest;
+            node_type* current = head->next;
+
+            if (current != nullptr && cmp(current->value, head->value))
+            {
+                node_type* const first = head;
+                head->next = nullptr;
+                try
+                {
+                    while (current != nullptr && cmp(current->value, head->value))
+                    {
+                        node_type* next = current->next;
+                        current->next = head;
+                        head = current;
+                        current = next;
+                    }
+                }
+                catch (...)
+                {
+                    // the reversed part stays in front of the unread nodes
+                    first->next = current;
+                    rest = head;
+                    throw;
+                }
+                rest = current;
+                return head;
+            }
+
+            node_type* last = head;
+            while (last->next != nullptr && !cmp(last->next->value, last->value))
+            { last = last->next; }
+            rest = last->next;
+            last->next = nullptr;
+            return head;
+        }
+
+        constexpr void relink(node_type* head) noexcept
+        {
+            head_ = head;
+            node_type* previous = nullptr;
+            for (node_type* node = head; node != nullptr; node = node->next)
+            {
+                node->previous = previous;
+                previous = node;
+            }
+            tail_ = previous;
+        }
+
+        constexpr void append_copy(const linked_list& other)
+        {
+            for (node_type* node = other.head_; node != nullptr; node = node->next)
+            { emplace_back(node->value); }
+        }
+
+        constexpr void steal(linked_list& other) noexcept
+        {
+            head_ = std::exchange(other.head_, nullptr);
+            tail_ = std::exchange(other.tail_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+
         [[nodiscard]] constexpr linked_list_node<value_type>* node_by_index(const size_t index) const
         {
             if (index >= size_)
@@ -535,6 +806,7 @@ namespace collections
             return node;
         }
 
+        [[no_unique_address]] node_allocator_type allocator_{};
         linked_list_node<value_type>* head_ = nullptr;
         linked_list_node<value_type>* tail_ = nullptr;
         size_t size_= 0;
@@ -547,4 +819,13 @@ namespace collections
     template<typename  IteratorType>
     linked_list(IteratorType, IteratorType)
     -> linked_list<typename std::iterator_traits<IteratorType>::value_type>;
+
+    template<typename T>
+    using pooled_linked_list = linked_list<T, pool_allocator<T>>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using linked_list = collections::linked_list<T, std::pmr::polymorphic_allocator<T>>;
+    }
 }
@@ -6,15 +6,15 @@ namespace collections
 {
     namespace sequence_companion
     {
-        template <typename T>
-        void concat_containers_mut(linked_list<T>& lhs, linked_list<T> rhs)
+        template <typename T, typename Allocator>
+        void concat_containers_mut(linked_list<T, Allocator>& lhs, linked_list<T, Allocator> rhs)
         {
             lhs.concat(std::move(rhs));
         }
 
-        template<typename T>
-        std::pair<linked_list<T>, linked_list<T>> cut_container_mut
-        (typename linked_list<T>::iterator index, linked_list<T>& cont)
+        template<typename T, typename Allocator>
+        std::pair<linked_list<T, Allocator>, linked_list<T, Allocator>> cut_container_mut
+        (typename linked_list<T, Allocator>::iterator index, linked_list<T, Allocator>& cont)
         {
             return cont.cut(index);
         }
@@ -26,7 +26,16 @@ namespace collections
 namespace collections
 {
 
+    template<typename T, typename Allocator = std::allocator<T>>
+    using list_sequence = collections::sequence<linked_list<T, Allocator>>;
+
     template<typename T>
-    using list_sequence = collections::sequence<linked_list<T>>;
+    using pooled_list_sequence = list_sequence<T, pool_allocator<T>>;
+
+    namespace pmr
+    {
+        template<typename T>
+        using list_sequence = collections::list_sequence<T, std::pmr::polymorphic_allocator<T>>;
+    }
 
 }
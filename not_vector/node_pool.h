@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace collections
+{
+    // Slab pool for single-object allocations of one size (list nodes).
+    // Blocks are carved from contiguous chunks and recycled through an intrusive free list.
+    // The block size is fixed by the first allocation, anything bigger or
+    // stricter aligned goes to the global heap. Not thread safe.
+    class node_pool
+    {
+        struct free_block
+        { free_block* next; };
+
+        struct chunk_header
+        { chunk_header* next; size_t bytes; };
+
+    public:
+        explicit node_pool(size_t first_chunk_blocks = 32, size_t max_chunk_blocks = 4096) noexcept
+            : next_chunk_blocks_(std::max(first_chunk_blocks, size_t{1})),
+            max_chunk_blocks_(std::max(max_chunk_blocks, next_chunk_blocks_)) { }
+
+        node_pool(const node_pool&) = delete;
+        node_pool(node_pool&&) = delete;
+
+        node_pool& operator=(const node_pool&) = delete;
+        node_pool& operator=(node_pool&&) = delete;
+
+        ~node_pool() noexcept
+        {
+            while (chunks_ != nullptr)
+            {
+                chunk_header* next = chunks_->next;
+                ::operator delete(chunks_, chunks_->bytes, std::align_val_t{block_alignment_});
+                chunks_ = next;
+            }
+        }
+
+        [[nodiscard]] void* allocate(size_t bytes, size_t alignment)
+        {
+            if (block_size_ == 0)
+            {
+                block_alignment_ = std::max(alignment, alignof(chunk_header));
+                block_size_ = round_up(std::max(bytes, sizeof(free_block)), block_alignment_);
+            }
+            if (!is_pooled(bytes, alignment))
+                return ::operator new(bytes, std::align_val_t{alignment});
+
+            if (free_list_ != nullptr)
+            {
+                free_block* block = free_list_;
+                free_list_ = block->next;
+                return block;
+            }
+            if (bump_ == bump_end_)
+                grow();
+
+            void* block = bump_;
+            bump_ += block_size_;
+            return block;
+        }
+
+        void deallocate(void* pointer, size_t bytes, size_t alignment) noexcept
+        {
+            if (!is_pooled(bytes, alignment))
+            {
+                ::operator delete(pointer, bytes, std::align_val_t{alignment});
+                return;
+            }
+            free_list_ = ::new(pointer) free_block{free_list_};
+        }
+
+        [[nodiscard]] size_t block_size() const noexcept
+        { return block_size_; }
+
+        [[nodiscard]] size_t chunks_count() const noexcept
+        {
+            size_t count = 0;
+            for (chunk_header* chunk = chunks_; chunk != nullptr; chunk = chunk->next)
+            { count += 1; }
+            return count;
+        }
+
+    private:
+        static constexpr size_t round_up(size_t value, size_t alignment) noexcept
+        { return (value + alignment - 1) / alignment * alignment; }
+
+        [[nodiscard]] bool is_pooled(size_t bytes, size_t alignment) const noexcept
+        { return bytes <= block_size_ && alignment <= block_alignment_; }
+
+        void grow()
+        {
+            const size_t header = round_up(sizeof(chunk_header), block_alignment_);
+            const size_t bytes = header + next_chunk_blocks_ * block_size_;
+            auto* memory = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{block_alignment_}));
+
+            chunks_ = ::new(memory) chunk_header{chunks_, bytes};
+            bump_ = memory + header;
+            bump_end_ = memory + bytes;
+            next_chunk_blocks_ = std::min(next_chunk_blocks_ * 2, max_chunk_blocks_);
+        }
+
+        size_t block_size_ = 0;
+        size_t block_alignment_ = alignof(chunk_header);
+        size_t next_chunk_blocks_;
+        size_t max_chunk_blocks_;
+
+        free_block* free_list_ = nullptr;
+        chunk_header* chunks_ = nullptr;
+        std::byte* bump_ = nullptr;
+        std::byte* bump_end_ = nullptr;
+    };
+
+
+    // Every default constructed allocator owns a fresh pool, copies share it.
+    // Containers that should splice nodes into each other have to share one pool.
+    template<typename T>
+    class pool_allocator
+    {
+        template<typename U>
+        friend class pool_allocator;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        pool_allocator()
+            : pool_(std::make_shared<node_pool>()) { }
+
+        explicit pool_allocator(std::shared_ptr<node_pool> pool) noexcept
+            : pool_(std::move(pool)) { }
+
+        template<typename U>
+        pool_allocator(const pool_allocator<U>& other) noexcept
+            : pool_(other.pool_) { }
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            if (n == 1)
+                return static_cast<T*>(pool_->allocate(sizeof(T), alignof(T)));
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+
+        void deallocate(T* pointer, size_t n) noexcept
+        {
+            if (n == 1)
+                pool_->deallocate(pointer, sizeof(T), alignof(T));
+            else
+                ::operator delete(pointer, n * sizeof(T), std::align_val_t{alignof(T)});
+        }
+
+        // a copied container gets its own pool instead of sharing the source one
+        [[nodiscard]] pool_allocator select_on_container_copy_construction() const
+        { return {}; }
+
+        [[nodiscard]] const std::shared_ptr<node_pool>& pool() const noexcept
+        { return pool_; }
+
+        template<typename U>
+        bool operator==(const pool_allocator<U>& other) const noexcept
+        { return pool_ == other.pool_; }
+
+    private:
+        std::shared_ptr<node_pool> pool_;
+    };
+}
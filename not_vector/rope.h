@@ -0,0 +1,699 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "dynamic_array.h"
+#include "utils.h"
+
+namespace collections
+{
+    // about eight cache lines of payload per leaf
+    template<typename T>
+    inline constexpr size_t rope_default_leaf_capacity = std::max<size_t>(8, 512 / sizeof(T));
+
+    // Leaves hold up to LeafCapacity values, inner nodes are AVL balanced by height.
+    // Nodes are shared between ropes and are only changed in place when uniquely owned
+    template<typename T, typename Allocator>
+    struct rope_node
+    {
+        using leaf_type = dynamic_array<T, Allocator>;
+
+        std::shared_ptr<rope_node> left;
+        std::shared_ptr<rope_node> right;
+        leaf_type values;
+        size_t size = 0;
+        // 0 for leaves
+        size_t height = 0;
+
+        [[nodiscard]] bool is_leaf() const noexcept
+        { return height == 0; }
+    };
+
+
+    template<typename T, typename Allocator>
+    class rope_iterator
+    {
+        using node_type = rope_node<T, Allocator>;
+
+    public:
+        using value_type        = T;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        constexpr rope_iterator() noexcept = default;
+
+        constexpr rope_iterator(const node_type* root, size_t index) noexcept
+            : root_(root), index_(index) { }
+
+        rope_iterator& operator++() noexcept
+        {
+            index_ += 1;
+            return *this;
+        }
+
+        rope_iterator operator++(int) noexcept
+        {
+            auto tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        rope_iterator& operator--() noexcept
+        {
+            index_ -= 1;
+            return *this;
+        }
+
+        rope_iterator operator--(int) noexcept
+        {
+            auto tmp(*this);
+            --(*this);
+            return tmp;
+        }
+
+        rope_iterator& operator+=(difference_type offset) noexcept
+        {
+            index_ += offset;
+            return *this;
+        }
+
+        rope_iterator& operator-=(difference_type offset) noexcept
+        {
+            index_ -= offset;
+            return *this;
+        }
+
+        rope_iterator operator+(difference_type offset) const noexcept
+        {
+            rope_iterator tmp(*this);
+            return (tmp += offset);
+        }
+
+        friend rope_iterator operator+(difference_type offset, const rope_iterator& it) noexcept
+        { return it + offset; }
+
+        rope_iterator operator-(difference_type offset) const noexcept
+        {
+            rope_iterator tmp(*this);
+            return (tmp -= offset);
+        }
+
+        difference_type operator-(const rope_iterator& other) const noexcept
+        { return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_); }
+
+        bool operator==(const rope_iterator& other) const noexcept
+        { return index_ == other.index_; }
+
+        std::strong_ordering operator<=>(const rope_iterator& other) const noexcept
+        { return index_ <=> other.index_; }
+
+        reference operator*() const noexcept
+        {
+            // the current leaf is cached, so sequential walks descend once per leaf
+            if (leaf_ == nullptr || index_ < leaf_begin_ || index_ - leaf_begin_ >= leaf_->size)
+                locate();
+            return leaf_->values[index_ - leaf_begin_];
+        }
+
+        pointer operator->() const noexcept
+        { return &**this; }
+
+        reference operator[](difference_type offset) const noexcept
+        { return *(*this + offset); }
+
+        [[nodiscard]] size_t index() const noexcept
+        { return index_; }
+
+    private:
+        void locate() const noexcept
+        {
+            const node_type* node = root_;
+            size_t begin = 0;
+            while (!node->is_leaf())
+            {
+                if (index_ - begin < node->left->size)
+                    node = node->left.get();
+                else
+                {
+                    begin += node->left->size;
+                    node = node->right.get();
+                }
+            }
+            leaf_ = node;
+            leaf_begin_ = begin;
+        }
+
+        const node_type* root_ = nullptr;
+        size_t index_ = 0;
+        mutable const node_type* leaf_ = nullptr;
+        mutable size_t leaf_begin_ = 0;
+    };
+
+
+    // Persistent sequence: copies share the whole tree in O(1),
+    // concat, cut, insert and erase are O(log n) and never touch the source tree.
+    // Iterators are read only and are invalidated by any modification.
+    // Nodes keep the allocator they were created with, so a tree can be shared
+    // between ropes with different allocators. Not thread safe.
+    template<
+        typename T,
+        size_t LeafCapacity = rope_default_leaf_capacity<T>,
+        typename Allocator = std::allocator<T>>
+    requires (LeafCapacity >= 2)
+    class rope
+    {
+        using node_type = rope_node<T, Allocator>;
+        using node_ptr = std::shared_ptr<node_type>;
+        using leaf_type = typename node_type::leaf_type;
+        using node_allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+        using node_traits = std::allocator_traits<node_allocator_type>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using iterator = rope_iterator<value_type, Allocator>;
+        using const_iterator = iterator;
+
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = reverse_iterator;
+
+        static constexpr size_t leaf_capacity = LeafCapacity;
+
+        rope() = default;
+
+        explicit rope(const allocator_type& allocator) noexcept
+            : allocator_(allocator) { }
+
+        explicit rope(
+            size_t count,
+            const value_type& default_value = {},
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
+        {
+            leaf_type leaf(get_allocator());
+            for (; count > 0; --count)
+            { emplace_into(leaf, default_value); }
+            flush(leaf);
+        }
+
+        template<typename IteratorType>
+        requires std::input_iterator<IteratorType>
+        rope(
+            IteratorType begin_it, IteratorType end_it,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
+        {
+            leaf_type leaf(get_allocator());
+            for (; begin_it != end_it; ++begin_it)
+            { emplace_into(leaf, *begin_it); }
+            flush(leaf);
+        }
+
+        rope(
+            std::initializer_list<value_type> list,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : rope(list.begin(), list.end(), allocator) { }
+
+        rope(const rope& other)
+            : root_(other.root_),
+            allocator_(node_traits::select_on_container_copy_construction(other.allocator_)) { }
+
+        rope(rope&& other) noexcept
+            : root_(std::move(other.root_)), allocator_(other.allocator_) { }
+
+        rope& operator=(const rope& other)
+        {
+            root_ = other.root_;
+            if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+                allocator_ = other.allocator_;
+            return *this;
+        }
+
+        rope& operator=(rope&& other) noexcept
+        {
+            root_ = std::move(other.root_);
+            if constexpr (node_traits::propagate_on_container_move_assignment::value)
+                allocator_ = other.allocator_;
+            return *this;
+        }
+
+        ~rope() = default;
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept
+        { return allocator_type(allocator_); }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return root_ ? root_->size : 0; }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return size() == 0; }
+
+        [[nodiscard]] size_t height() const noexcept
+        { return root_ ? root_->height : 0; }
+
+        const value_type& operator[](size_t index) const
+        {
+            check_index(index, size());
+            auto [leaf, offset] = locate(index);
+            return leaf->values[offset];
+        }
+
+        value_type& operator[](size_t index)
+        {
+            check_index(index, size());
+            const size_t offset = locate(index).second;
+            return unique_leaf(index)[offset];
+        }
+
+        const value_type& at(size_t index) const
+        { return (*this)[index]; }
+
+        value_type& at(size_t index)
+        { return (*this)[index]; }
+
+        void push_back(const value_type& value)
+        { emplace(size(), value); }
+
+        void push_back(value_type&& value)
+        { emplace(size(), std::move(value)); }
+
+        void push_front(const value_type& value)
+        { emplace(0, value); }
+
+        void push_front(value_type&& value)
+        { emplace(0, std::move(value)); }
+
+        void insert(size_t index, const value_type& value)
+        { emplace(index, value); }
+
+        void insert(size_t index, value_type&& value)
+        { emplace(index, std::move(value)); }
+
+        template<class ...ArgsTy>
+        void emplace_back(ArgsTy&& ...args)
+        { emplace(size(), std::forward<ArgsTy>(args)...); }
+
+        template<class ...ArgsTy>
+        void emplace_front(ArgsTy&& ...args)
+        { emplace(0, std::forward<ArgsTy>(args)...); }
+
+        template<class ...ArgsTy>
+        void emplace(size_t index, ArgsTy&& ...args)
+        {
+            const size_t old_size = size();
+            if (index > old_size)
+                throw_out_of_range(index);
+
+            // appending goes to the last leaf
+            const size_t path_index = index == old_size ? index - 1 : index;
+            if (root_ && locate(path_index).first->size < LeafCapacity)
+            {
+                // room in the leaf: change it in place, copying the shared part of the path
+                const size_t offset = index == old_size ? locate(path_index).second + 1 : locate(index).second;
+                leaf_type& values = unique_leaf(path_index);
+                values.emplace_back(std::forward<ArgsTy>(args)...);
+                std::rotate(values.begin() + offset, values.end() - 1, values.end());
+                fix_sizes(path_index, +1);
+                return;
+            }
+
+            leaf_type leaf(get_allocator());
+            leaf.emplace_back(std::forward<ArgsTy>(args)...);
+            auto [left, right] = split(root_, index);
+            root_ = join(join(std::move(left), make_leaf(std::move(leaf))), std::move(right));
+        }
+
+        template<class ...ArgsTy>
+        void emplace(const_iterator position, ArgsTy&& ...args)
+        { emplace(position.index(), std::forward<ArgsTy>(args)...); }
+
+        value_type pop_back()
+        {
+            if (size() == 0)
+            { throw std::runtime_error("rope size = 0"); }
+            return extract(size() - 1);
+        }
+
+        value_type pop_front()
+        {
+            if (size() == 0)
+            { throw std::runtime_error("rope size = 0"); }
+            return extract(0);
+        }
+
+        value_type extract(size_t index)
+        {
+            value_type tmp = std::as_const(*this)[index];
+            erase(index);
+            return tmp;
+        }
+
+        void erase(size_t index)
+        {
+            check_index(index, size());
+            if (locate(index).first->size > 1)
+            {
+                const size_t offset = locate(index).second;
+                leaf_type& values = unique_leaf(index);
+                std::rotate(values.begin() + offset, values.begin() + offset + 1, values.end());
+                values.pop_back();
+                fix_sizes(index, -1);
+                return;
+            }
+            erase(index, index + 1);
+        }
+
+        void erase(size_t left_index, size_t right_index)
+        {
+            if (left_index > right_index || right_index > size())
+                throw std::out_of_range("rope erase range out of range");
+
+            auto [left, tail] = split(root_, left_index);
+            auto [middle, right] = split(std::move(tail), right_index - left_index);
+            root_ = concat_nodes(std::move(left), std::move(right));
+        }
+
+        void erase(const_iterator position)
+        { erase(position.index()); }
+
+        void erase(const_iterator left_it, const_iterator right_it)
+        { erase(left_it.index(), right_it.index()); }
+
+        // O(log n), other is shared, not copied
+        void concat(const rope& other)
+        { root_ = concat_nodes(root_, other.root_); }
+
+        // O(log n), both parts share the untouched nodes with this rope
+        std::pair<rope, rope> cut(size_t index) const
+        {
+            if (index > size())
+                throw_out_of_range(index);
+
+            auto [left, right] = split(root_, index);
+            return { rope(std::move(left), get_allocator()), rope(std::move(right), get_allocator()) };
+        }
+
+        std::pair<rope, rope> cut(const_iterator edge) const
+        { return cut(edge.index()); }
+
+        rope subrope(size_t left_index, size_t right_index) const
+        {
+            if (left_index > right_index || right_index > size())
+                throw std::out_of_range("rope subrope range out of range");
+
+            auto [head, right] = split(root_, right_index);
+            auto [left, middle] = split(std::move(head), left_index);
+            return rope(std::move(middle), get_allocator());
+        }
+
+        [[nodiscard]] iterator begin() const noexcept
+        { return iterator{root_.get(), 0}; }
+        [[nodiscard]] iterator end() const noexcept
+        { return iterator{root_.get(), size()}; }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept
+        { return begin(); }
+        [[nodiscard]] const_iterator cend() const noexcept
+        { return end(); }
+
+        [[nodiscard]] reverse_iterator rbegin() const noexcept
+        { return std::make_reverse_iterator(end()); }
+        [[nodiscard]] reverse_iterator rend() const noexcept
+        { return std::make_reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rcbegin() const noexcept
+        { return rbegin(); }
+        [[nodiscard]] const_reverse_iterator rcend() const noexcept
+        { return rend(); }
+
+        void swap(rope& other) noexcept
+        {
+            std::swap(root_, other.root_);
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                using std::swap;
+                swap(allocator_, other.allocator_);
+            }
+        }
+
+        void clear() noexcept
+        { root_.reset(); }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        auto operator<=>(const Container& container) const noexcept
+        { return compare_collections(*this, container); }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        bool operator==(const Container& container) const noexcept
+        {
+            if constexpr (std::same_as<Container, rope>)
+            {
+                if (root_ == container.root_)
+                    return true;
+            }
+            return is_equal_collections(*this, container);
+        }
+
+    private:
+        rope(node_ptr root, const allocator_type& allocator) noexcept
+            : root_(std::move(root)), allocator_(allocator) { }
+
+        static void check_index(size_t index, size_t size)
+        {
+            if (index >= size)
+                throw std::out_of_range(
+                    "in rope index out of range (index) "
+                    + std::to_string(index) + " >= (size) " + std::to_string(size));
+        }
+
+        [[noreturn]] void throw_out_of_range(size_t index) const
+        {
+            throw std::out_of_range(
+                "in rope index out of range (index) "
+                + std::to_string(index) + " > (size) " + std::to_string(size()));
+        }
+
+        static size_t height_of(const node_ptr& node) noexcept
+        { return node ? node->height : 0; }
+
+        // leaf holding the element and the element offset in it
+        [[nodiscard]] std::pair<const node_type*, size_t> locate(size_t index) const noexcept
+        {
+            const node_type* node = root_.get();
+            while (!node->is_leaf())
+            {
+                if (index < node->left->size)
+                    node = node->left.get();
+                else
+                {
+                    index -= node->left->size;
+                    node = node->right.get();
+                }
+            }
+            return { node, index };
+        }
+
+        // copy-on-write for a node reached through a uniquely owned parent
+        void make_unique(node_ptr& node)
+        {
+            if (node.use_count() != 1)
+                node = std::allocate_shared<node_type>(allocator_, *node);
+        }
+
+        // copies the part of the path to the leaf that is shared with another rope
+        leaf_type& unique_leaf(size_t index)
+        {
+            node_ptr* node = &root_;
+            for (;;)
+            {
+                make_unique(*node);
+                if ((*node)->is_leaf())
+                    return (*node)->values;
+                if (index < (*node)->left->size)
+                    node = &(*node)->left;
+                else
+                {
+                    index -= (*node)->left->size;
+                    node = &(*node)->right;
+                }
+            }
+        }
+
+        // walks the path of the pre-change sizes, children are fixed after their parent
+        void fix_sizes(size_t index, int delta) noexcept
+        {
+            node_type* node = root_.get();
+            for (;;)
+            {
+                node->size += delta;
+                if (node->is_leaf())
+                    return;
+                if (index < node->left->size)
+                    node = node->left.get();
+                else
+                {
+                    index -= node->left->size;
+                    node = node->right.get();
+                }
+            }
+        }
+
+        node_ptr make_leaf(leaf_type&& values) const
+        {
+            const size_t size = values.size();
+            return std::allocate_shared<node_type>(allocator_, nullptr, nullptr, std::move(values), size, 0);
+        }
+
+        node_ptr make_node(node_ptr left, node_ptr right) const
+        {
+            auto node = std::allocate_shared<node_type>(allocator_);
+            node->size = left->size + right->size;
+            node->height = 1 + std::max(left->height, right->height);
+            node->left = std::move(left);
+            node->right = std::move(right);
+            return node;
+        }
+
+        // subtrees heights differ at most by two
+        node_ptr make_balanced(node_ptr left, node_ptr right) const
+        {
+            if (left->height > right->height + 1)
+            {
+                if (left->left->height >= left->right->height)
+                    return make_node(left->left, make_node(left->right, std::move(right)));
+                return make_node(
+                    make_node(left->left, left->right->left),
+                    make_node(left->right->right, std::move(right)));
+            }
+            if (right->height > left->height + 1)
+            {
+                if (right->right->height >= right->left->height)
+                    return make_node(make_node(std::move(left), right->left), right->right);
+                return make_node(
+                    make_node(std::move(left), right->left->left),
+                    make_node(right->left->right, right->right));
+            }
+            return make_node(std::move(left), std::move(right));
+        }
+
+        // AVL join, O(|height(left) - height(right)| + 1)
+        node_ptr join(node_ptr left, node_ptr right) const
+        {
+            if (!left)
+                return right;
+            if (!right)
+                return left;
+
+            if (left->is_leaf() && right->is_leaf() && left->size + right->size <= LeafCapacity)
+            {
+                leaf_type values(left->values);
+                values.reserve(left->size + right->size);
+                for (const auto& value : right->values)
+                { values.push_back(value); }
+                return make_leaf(std::move(values));
+            }
+            if (left->height > right->height + 1)
+                return make_balanced(left->left, join(left->right, std::move(right)));
+            if (right->height > left->height + 1)
+                return make_balanced(join(std::move(left), right->left), right->right);
+            return make_node(std::move(left), std::move(right));
+        }
+
+        std::pair<node_ptr, node_ptr> split(node_ptr node, size_t index) const
+        {
+            if (!node || index == 0)
+                return { nullptr, std::move(node) };
+            if (index == node->size)
+                return { std::move(node), nullptr };
+
+            if (node->is_leaf())
+            {
+                const auto& values = node->values;
+                return {
+                    make_leaf(leaf_type(values.begin(), values.begin() + index, get_allocator())),
+                    make_leaf(leaf_type(values.begin() + index, values.end(), get_allocator()))
+                };
+            }
+            if (index <= node->left->size)
+            {
+                auto [left, middle] = split(node->left, index);
+                return { std::move(left), join(std::move(middle), node->right) };
+            }
+            auto [middle, right] = split(node->right, index - node->left->size);
+            return { join(node->left, std::move(middle)), std::move(right) };
+        }
+
+        // join that also merges the two boundary leaves when they fit in one,
+        // so repeated cut and concat do not leave the tree full of tiny leaves
+        node_ptr concat_nodes(node_ptr left, node_ptr right) const
+        {
+            if (!left)
+                return right;
+            if (!right)
+                return left;
+
+            const node_type* last = left.get();
+            while (!last->is_leaf())
+            { last = last->right.get(); }
+            const node_type* first = right.get();
+            while (!first->is_leaf())
+            { first = first->left.get(); }
+
+            if (last->size + first->size > LeafCapacity || (left->is_leaf() && right->is_leaf()))
+                return join(std::move(left), std::move(right));
+
+            const size_t left_rest_size = left->size - last->size, first_size = first->size;
+            auto [left_rest, last_leaf] = split(std::move(left), left_rest_size);
+            auto [first_leaf, right_rest] = split(std::move(right), first_size);
+            return join(join(std::move(left_rest), join(std::move(last_leaf), std::move(first_leaf))),
+                std::move(right_rest));
+        }
+
+        template<typename ValueType>
+        void emplace_into(leaf_type& leaf, ValueType&& value)
+        {
+            if (leaf.size() == LeafCapacity)
+                flush(leaf);
+            if (leaf.capacity() == 0)
+                leaf.reserve(LeafCapacity);
+            leaf.emplace_back(std::forward<ValueType>(value));
+        }
+
+        // appends a full leaf along the right spine
+        void flush(leaf_type& leaf)
+        {
+            if (leaf.empty())
+                return;
+            root_ = join(std::move(root_), make_leaf(std::move(leaf)));
+            leaf = leaf_type(get_allocator());
+        }
+
+        node_ptr root_ = nullptr;
+        [[no_unique_address]] node_allocator_type allocator_{};
+    };
+
+    template<typename IteratorType>
+    rope(IteratorType, IteratorType)
+    -> rope<typename std::iterator_traits<IteratorType>::value_type>;
+
+    namespace pmr
+    {
+        template<typename T, size_t LeafCapacity = rope_default_leaf_capacity<T>>
+        using rope = collections::rope<T, LeafCapacity, std::pmr::polymorphic_allocator<T>>;
+    }
+}
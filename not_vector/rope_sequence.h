@@ -0,0 +1,42 @@
+#pragma once
+#include "rope.h"
+
+
+namespace collections
+{
+    namespace sequence_companion
+    {
+        template <typename T, size_t LeafCapacity, typename Allocator>
+        void concat_containers_mut(rope<T, LeafCapacity, Allocator>& lhs, rope<T, LeafCapacity, Allocator> rhs)
+        {
+            lhs.concat(rhs);
+        }
+
+        template<typename T, size_t LeafCapacity, typename Allocator>
+        std::pair<rope<T, LeafCapacity, Allocator>, rope<T, LeafCapacity, Allocator>> cut_container_mut
+        (typename rope<T, LeafCapacity, Allocator>::iterator index, rope<T, LeafCapacity, Allocator>& cont)
+        {
+            return cont.cut(index);
+        }
+    }
+}
+
+#include "sequence.h"
+
+namespace collections
+{
+
+    template<typename T, size_t LeafCapacity = rope_default_leaf_capacity<T>, typename Allocator = std::allocator<T>>
+    using rope_sequence = collections::sequence<rope<T, LeafCapacity, Allocator>>;
+
+    // append_back, append_front, insert, cut and get_subsequence share the tree
+    // with the source sequence instead of copying it
+    template<typename T>
+    using persistent_sequence = rope_sequence<T>;
+
+    namespace pmr
+    {
+        template<typename T, size_t LeafCapacity = rope_default_leaf_capacity<T>>
+        using rope_sequence = collections::rope_sequence<T, LeafCapacity, std::pmr::polymorphic_allocator<T>>;
+    }
+}
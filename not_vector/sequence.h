@@ -1,20 +1,45 @@
 ﻿#pragma once
+#include <algorithm>
 #include <concepts>
 #include "utils.h"
 
 
 namespace collections
 {
+    template<typename Container>
+    requires is_container<Container>
+    class sequence_view;
+
     namespace sequence_companion
     {
+        // Containers with their own concat/cut are used as is, the others get
+        // a single relocation pass and reuse lhs storage where they can
         template <typename Container, typename OtherContainer>
         requires is_containers_with_same_intypes<Container, OtherContainer>
             constexpr void concat_containers_mut(Container& lhs, OtherContainer rhs)
         {
-            Container tmp(lhs.size() + rhs.size());
-            auto end_it = std::move(lhs.begin(), lhs.end(), tmp.begin());
-            std::move((rhs.begin()), rhs.end(), end_it);
-            lhs = tmp;
+            if constexpr (std::same_as<Container, OtherContainer> && is_concatable<Container>)
+            { lhs.concat(std::move(rhs)); }
+            else if constexpr (is_range_insertable<Container>)
+            {
+                lhs.insert(lhs.end(),
+                    std::make_move_iterator(std::begin(rhs)), std::make_move_iterator(std::end(rhs)));
+            }
+            else if constexpr (is_reservable<Container>)
+            {
+                const size_t required = lhs.size() + rhs.size();
+                if (required > lhs.capacity())
+                    lhs.reserve(std::max(required, lhs.capacity() * 2));
+                for (auto& value : rhs)
+                { lhs.push_back(std::move(value)); }
+            }
+            else
+            {
+                Container tmp(lhs.size() + rhs.size());
+                auto end_it = std::move(lhs.begin(), lhs.end(), tmp.begin());
+                std::move((rhs.begin()), rhs.end(), end_it);
+                lhs = std::move(tmp);
+            }
         }
 
         template <typename Container, typename OtherContainer>
@@ -32,9 +57,21 @@ namespace collections
             constexpr std::pair<Container, Container> cut_container_mut
             (typename Container::iterator index, Container& cont)
         {
-            Container left{ std::make_move_iterator(cont.begin()), std::make_move_iterator(index) };
-            Container right{ std::make_move_iterator(index), std::make_move_iterator(cont.end()) };
-            return { left, right };
+            if constexpr (is_cuttable<Container>)
+                return cont.cut(index);
+            else if constexpr (is_range_erasable<Container>)
+            {
+                // only the right part is relocated, the left one keeps the storage
+                Container right{ std::make_move_iterator(index), std::make_move_iterator(cont.end()) };
+                cont.erase(index, cont.end());
+                return { std::move(cont), std::move(right) };
+            }
+            else
+            {
+                Container left{ std::make_move_iterator(cont.begin()), std::make_move_iterator(index) };
+                Container right{ std::make_move_iterator(index), std::make_move_iterator(cont.end()) };
+                return { std::move(left), std::move(right) };
+            }
         }
 
         template <typename Container>
@@ -42,11 +79,25 @@ namespace collections
             constexpr std::pair<Container, Container> cut_container
             (typename Container::const_iterator index, const Container& cont)
         {
-            Container tmp(cont);
-            auto it = tmp.begin();
-            std::advance(it, std::distance(cont.cbegin(), index));
-            auto res = cut_container_mut<Container>(it, tmp);
-            return res;
+            if constexpr (is_persistent_container<Container>)
+                return cont.cut(index);
+            else
+            {
+                Container left(cont.cbegin(), index);
+                Container right(index, cont.cend());
+                return { std::move(left), std::move(right) };
+            }
+        }
+
+        // containers with their own positional lookup skip the linear advance
+        template <typename Container>
+        requires is_container<std::remove_const_t<Container>>
+            constexpr auto iterator_at(Container& cont, size_t index)
+        {
+            if constexpr (has_iterator_at<std::remove_const_t<Container>>)
+                return cont.iterator_at(index);
+            else
+                return advance_s(cont.begin(), index);
         }
 
     }
@@ -154,34 +205,34 @@ namespace collections
             auto [left, right]
                 = sequence_companion::cut_container_mut(index, (container_));
             container_ = {};
-            return { sequence{(left)}, sequence{(right)} };
+            return { sequence{std::move(left)}, sequence{std::move(right)} };
         }
 
         constexpr std::pair<sequence, sequence> cut_mut(size_t index)
         { return cut_mut(iterator_by_index(index)); }
 
         constexpr sequence extract_subsequence(iterator left_it, iterator right_it)
-        {
-            size_t dist = std::distance(left_it, right_it);
-            auto [left, tail]
-                = sequence_companion::cut_container_mut(left_it, (container_));
-            auto new_right_it = advance_s(tail.begin(), dist);
-            auto [middle, right]
-                = sequence_companion::cut_container_mut(new_right_it, (tail));
-            sequence_companion::concat_containers_mut(left, right);
-            container_ = left;
-            return middle;
-        }
+        { return extract_range(left_it, static_cast<size_t>(std::distance(left_it, right_it))); }
 
         constexpr sequence extract_subsequence(size_t left_index = 0, size_t right_index = static_cast<size_t>(-1))
         {
             right_index = (right_index == static_cast<size_t>(-1) ? this->size() : right_index);
             auto [it_left, it_right] = range_by_indexes(left_index, right_index);
-            return extract_subsequence(it_left, it_right);
+            return extract_range(it_left, right_index - left_index);
         }
 
         constexpr sequence get_subsequence(const_iterator left_it, const_iterator right_it) const
-        { return  { Container{left_it, right_it} }; }
+        {
+            if constexpr (is_persistent_container<Container>)
+            {
+                const auto left_index = std::distance(cbegin(), left_it);
+                auto [head, tail] = container_.cut(right_it);
+                auto [left, middle] = head.cut(advance_s(head.cbegin(), left_index));
+                return { std::move(middle) };
+            }
+            else
+                return { Container{left_it, right_it} };
+        }
 
         constexpr sequence get_subsequence(size_t left_index = 0, size_t right_index = static_cast<size_t>(-1)) const
         {
@@ -190,8 +241,19 @@ namespace collections
             return get_subsequence(it_left, it_right);
         }
 
-        constexpr Container&& release_container()
-        { return std::move(container_); }
+        // non owning, valid while the sequence is not modified
+        constexpr sequence_view<Container> view() const
+        { return { cbegin(), cend(), size() }; }
+
+        constexpr sequence_view<Container> subsequence_view(const_iterator left_it, const_iterator right_it) const
+        { return { left_it, right_it }; }
+
+        constexpr sequence_view<Container> subsequence_view(
+            size_t left_index = 0, size_t right_index = static_cast<size_t>(-1)) const
+        { return view().subview(left_index, right_index); }
+
+        constexpr Container release_container()
+        { return std::exchange(container_, Container{}); }
 
         constexpr sequence append_back(const sequence& other) const
         { return append_back<Container>(other); }
@@ -202,7 +264,7 @@ namespace collections
         constexpr sequence insert(size_t index, const sequence& other) const
         { return insert<Container>(index, other); }
 
-        constexpr sequence insert(iterator index, const sequence& other) const
+        constexpr sequence insert(const_iterator index, const sequence& other) const
         { return insert<Container>(index, other); }
 
         template<typename OtherContainer = Container>
@@ -218,17 +280,16 @@ namespace collections
         template<typename OtherContainer = Container>
         requires std::ranges::range<OtherContainer>
             sequence insert(size_t index, const sequence<OtherContainer>& other) const
-        { return insert(iterator_by_index(index)); }
+        { return insert<OtherContainer>(iterator_by_index(index), other); }
 
 
         template<typename OtherContainer = Container>
         requires std::ranges::range<OtherContainer>
-            sequence insert(iterator index, const sequence<OtherContainer>& other) const
+            sequence insert(const_iterator index, const sequence<OtherContainer>& other) const
         {
-            auto [left, right] = sequence_companion::cut_container(index, container_);
-            Container middle = Container(other);
+            auto [left, right] = sequence_companion::cut_container<Container>(index, container_);
 
-            sequence_companion::concat_containers_mut(left, std::move(middle));
+            sequence_companion::concat_containers_mut(left, other.container_);
             sequence_companion::concat_containers_mut(left, std::move(right));
 
             return { std::move(left) };
@@ -242,23 +303,25 @@ namespace collections
         constexpr sequence insert(size_t index, T&& value) const
         { return insert<Container>(index, Container( 1, std::forward<T>(value) )); }
     
-        constexpr sequence insert(iterator index, T&& value) const
+        constexpr sequence insert(const_iterator index, T&& value) const
         { return insert<Container>(index, Container( 1, std::forward<T>(value) )); }
 
         template<typename OtherContainer = Container>
         requires std::ranges::range<OtherContainer>
             void append_back_mut(sequence<OtherContainer> other)
-        {
-            sequence_companion::concat_containers_mut<Container, OtherContainer>
-                (container_, std::move(other.container_));
-        }
+        { sequence_companion::concat_containers_mut(container_, std::move(other.container_)); }
 
         template<typename OtherContainer = Container>
         requires std::ranges::range<OtherContainer>
             void append_front_mut(sequence<OtherContainer> other)
         {
-            sequence_companion::concat_containers_mut<OtherContainer, Container>(other.container_, std::move(container_));
-            container_ = std::move(other.container_);
+            if constexpr (is_range_insertable<Container>)
+                insert_mut<OtherContainer>(begin(), std::move(other));
+            else
+            {
+                sequence_companion::concat_containers_mut(other.container_, std::move(container_));
+                container_ = std::move(other.container_);
+            }
         }
 
         template<typename OtherContainer = Container>
@@ -270,12 +333,21 @@ namespace collections
         requires std::ranges::range<OtherContainer>
             void insert_mut(iterator index, sequence<OtherContainer> other)
         {
-            auto [left, right] = sequence_companion::cut_container_mut(index, (container_));
+            if constexpr (is_range_insertable<Container>)
+            {
+                container_.insert(index,
+                    std::make_move_iterator(std::begin(other.container_)),
+                    std::make_move_iterator(std::end(other.container_)));
+            }
+            else
+            {
+                auto [left, right] = sequence_companion::cut_container_mut(index, container_);
 
-            sequence_companion::concat_containers_mut<Container, OtherContainer>(left, std::move(other.container_));
-            sequence_companion::concat_containers_mut<Container, OtherContainer>(left, std::move(right));
+                sequence_companion::concat_containers_mut(left, std::move(other.container_));
+                sequence_companion::concat_containers_mut(left, std::move(right));
 
-            container_ = std::move(left);
+                container_ = std::move(left);
+            }
         }
 
         constexpr void append_back_mut(sequence other)
@@ -339,6 +411,29 @@ namespace collections
 
     protected:
 
+        constexpr sequence extract_range(iterator left_it, size_t length)
+        {
+            if constexpr (!is_cuttable<Container> && is_range_erasable<Container>)
+            {
+                // one pass builds the extracted part, erase closes the gap in place
+                auto right_it = advance_s(left_it, length);
+                Container middle(std::make_move_iterator(left_it), std::make_move_iterator(right_it));
+                container_.erase(left_it, right_it);
+                return { std::move(middle) };
+            }
+            else
+            {
+                auto [left, tail]
+                    = sequence_companion::cut_container_mut(left_it, (container_));
+                auto right_it = sequence_companion::iterator_at(tail, length);
+                auto [middle, right]
+                    = sequence_companion::cut_container_mut(right_it, (tail));
+                sequence_companion::concat_containers_mut(left, std::move(right));
+                container_ = std::move(left);
+                return { std::move(middle) };
+            }
+        }
+
         constexpr iterator iterator_by_index(size_t index)
         {
             if (index > size())
@@ -348,7 +443,7 @@ namespace collections
                     + " when size() = "
                     + std::to_string(size()) + "\n");
 
-            return advance_s(begin(), index);
+            return sequence_companion::iterator_at(container_, index);
         }
 
         constexpr const_iterator iterator_by_index(size_t index) const
@@ -360,7 +455,7 @@ namespace collections
                     + " when size() = "
                     + std::to_string(size()) + "\n");
 
-            return advance_s(begin(), index);
+            return sequence_companion::iterator_at(container_, index);
         }
 
         constexpr std::pair<iterator, iterator>
@@ -380,8 +475,13 @@ namespace collections
                     + " when left = "
                     + std::to_string(left) + "\n");
 
-            auto l = advance_s(begin(), left);
-            return { l, advance_s(l, right - left) };
+            if constexpr (has_iterator_at<Container>)
+                return { container_.iterator_at(left), container_.iterator_at(right) };
+            else
+            {
+                auto l = advance_s(begin(), left);
+                return { l, advance_s(l, right - left) };
+            }
         }
 
         constexpr std::pair<const_iterator, const_iterator>
@@ -397,8 +497,96 @@ namespace collections
                     "Sequence out of range left > right, right = " + std::to_string(right)
                     + " when left = " + std::to_string(left) + "\n");
 
-            auto l = advance_s(begin(), left);
-            return { l, advance_s(l, right - left) };
+            if constexpr (has_iterator_at<Container>)
+                return { container_.iterator_at(left), container_.iterator_at(right) };
+            else
+            {
+                auto l = advance_s(begin(), left);
+                return { l, advance_s(l, right - left) };
+            }
         }
     };
+
+
+    // Non owning slice of a sequence: iteration, indexing and nested slicing
+    // without copying, materialize() builds an owning sequence on demand
+    template<typename Container>
+    requires is_container<Container>
+    class sequence_view : public std::ranges::view_interface<sequence_view<Container>>
+    {
+    public:
+        using value_type = typename Container::value_type;
+        using iterator = typename Container::const_iterator;
+        using const_iterator = iterator;
+
+        constexpr sequence_view() = default;
+
+        constexpr sequence_view(const_iterator begin_it, const_iterator end_it)
+            : begin_(begin_it), end_(end_it), size_(std::distance(begin_it, end_it)) { }
+
+        constexpr sequence_view(const_iterator begin_it, const_iterator end_it, size_t size)
+            : begin_(begin_it), end_(end_it), size_(size) { }
+
+        constexpr const_iterator begin() const
+        { return begin_; }
+        constexpr const_iterator end() const
+        { return end_; }
+
+        constexpr size_t size() const
+        { return size_; }
+
+        constexpr const value_type& operator[](size_t index) const
+        { return *advance_s(begin_, index); }
+
+        constexpr const value_type& at(size_t index) const
+        {
+            if (index >= size_)
+                throw std::out_of_range(
+                    "Sequence view index out of range, index = "
+                    + std::to_string(index)
+                    + " when size() = "
+                    + std::to_string(size_) + "\n");
+
+            return (*this)[index];
+        }
+
+        constexpr sequence_view subview(size_t left_index = 0, size_t right_index = static_cast<size_t>(-1)) const
+        {
+            right_index = (right_index == static_cast<size_t>(-1) ? size_ : right_index);
+            if (right_index > size_)
+                throw std::out_of_range(
+                    "Sequence view index out of range, right = " + std::to_string(right_index)
+                    + " when size() = " + std::to_string(size_) + "\n");
+
+            if (left_index > right_index)
+                throw std::invalid_argument(
+                    "Sequence view out of range left > right, right = " + std::to_string(right_index)
+                    + " when left = " + std::to_string(left_index) + "\n");
+
+            auto l = advance_s(begin_, left_index);
+            return { l, advance_s(l, right_index - left_index), right_index - left_index };
+        }
+
+        constexpr std::pair<sequence_view, sequence_view> cut(size_t index) const
+        { return { subview(0, index), subview(index) }; }
+
+        constexpr sequence<Container> materialize() const
+        { return { Container(begin_, end_) }; }
+
+        template<typename OtherContainer>
+        requires std::ranges::range<OtherContainer>
+            bool operator==(const OtherContainer& other) const
+        { return is_equal_collections(*this, other); }
+
+    private:
+        const_iterator begin_{};
+        const_iterator end_{};
+        size_t size_ = 0;
+    };
+}
+
+namespace std::ranges
+{
+    template<typename Container>
+    inline constexpr bool enable_borrowed_range<collections::sequence_view<Container>> = true;
 }
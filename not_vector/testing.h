@@ -4,6 +4,7 @@
 #include <random>
 #include <boost/mpl/for_each.hpp>
 
+#include "counting_allocator.h"
 #include "profiler.h"
 #include "test_runner.h"
 #include "stress_tests.h"
@@ -0,0 +1,713 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "utils.h"
+
+namespace collections
+{
+    // about four cache lines of payload per chunk
+    template<typename T>
+    inline constexpr size_t unrolled_list_default_capacity = std::max<size_t>(4, 256 / sizeof(T));
+
+    template<typename T, size_t Capacity>
+    struct unrolled_list_chunk
+    {
+        unrolled_list_chunk* next = nullptr;
+        unrolled_list_chunk* previous = nullptr;
+        size_t size = 0;
+        alignas(T) std::byte storage[Capacity * sizeof(T)];
+
+        T* values() noexcept
+        { return std::launder(reinterpret_cast<T*>(storage)); }
+
+        const T* values() const noexcept
+        { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+        [[nodiscard]] bool full() const noexcept
+        { return size == Capacity; }
+    };
+
+
+    template<typename T, size_t Capacity, typename Allocator>
+    requires (Capacity >= 2)
+    class unrolled_list;
+
+    template<typename T, size_t Capacity, bool Const>
+    class unrolled_list_iterator
+    {
+        using chunk_type = std::conditional_t<Const,
+            const unrolled_list_chunk<T, Capacity>, unrolled_list_chunk<T, Capacity>>;
+
+    public:
+        using value_type        = T;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type   = ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+
+        constexpr unrolled_list_iterator() noexcept = default;
+
+        constexpr unrolled_list_iterator(chunk_type* chunk, size_t index) noexcept
+            : chunk_(chunk), index_(index) { }
+
+        template<bool OtherConst>
+        requires (Const && !OtherConst)
+        constexpr unrolled_list_iterator(const unrolled_list_iterator<T, Capacity, OtherConst>& other) noexcept
+            : chunk_(other.chunk_), index_(other.index_) { }
+
+        unrolled_list_iterator& operator++() noexcept
+        {
+            index_ += 1;
+            if (index_ == chunk_->size && chunk_->next != nullptr)
+            {
+                chunk_ = chunk_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        unrolled_list_iterator operator++(int) noexcept
+        {
+            auto tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        unrolled_list_iterator& operator--() noexcept
+        {
+            if (index_ == 0)
+            {
+                chunk_ = chunk_->previous;
+                index_ = chunk_->size;
+            }
+            index_ -= 1;
+            return *this;
+        }
+
+        unrolled_list_iterator operator--(int) noexcept
+        {
+            auto tmp(*this);
+            --(*this);
+            return tmp;
+        }
+
+        constexpr bool operator==(const unrolled_list_iterator& other) const noexcept = default;
+
+        reference operator*() const noexcept
+        { return chunk_->values()[index_]; }
+
+        pointer operator->() const noexcept
+        { return chunk_->values() + index_; }
+
+    private:
+        template<typename, size_t, bool>
+        friend class unrolled_list_iterator;
+
+        template<typename ValueType, size_t ChunkCapacity, typename Allocator>
+        requires (ChunkCapacity >= 2)
+        friend class unrolled_list;
+
+        chunk_type* chunk_ = nullptr;
+        size_t index_ = 0;
+    };
+
+
+    // Doubly linked list of fixed capacity chunks: list-like O(1) splicing
+    // with array-like locality and per element overhead
+    template<
+        typename T,
+        size_t Capacity = unrolled_list_default_capacity<T>,
+        typename Allocator = std::allocator<T>>
+    requires (Capacity >= 2)
+    class unrolled_list
+    {
+        using chunk_type = unrolled_list_chunk<T, Capacity>;
+        using chunk_allocator_type =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<chunk_type>;
+        using chunk_traits = std::allocator_traits<chunk_allocator_type>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using iterator = unrolled_list_iterator<value_type, Capacity, false>;
+        using const_iterator = unrolled_list_iterator<value_type, Capacity, true>;
+
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_t chunk_capacity = Capacity;
+
+        unrolled_list() noexcept = default;
+
+        explicit unrolled_list(const allocator_type& allocator) noexcept
+            : allocator_(allocator) { }
+
+        explicit unrolled_list(
+            size_t count,
+            const value_type& default_value = {},
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
+        {
+            for (; count > 0; --count)
+            { emplace_back(default_value); }
+        }
+
+        template<typename IteratorType>
+        requires std::input_iterator<IteratorType>
+        unrolled_list(
+            IteratorType begin_it, IteratorType end_it,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
+        {
+            for (; begin_it != end_it; ++begin_it)
+            { emplace_back(*begin_it); }
+        }
+
+        unrolled_list(
+            std::initializer_list<value_type> list,
+            const allocator_type& allocator = allocator_type{}
+        )
+            : allocator_(allocator)
+        {
+            for (const auto& i : list)
+            { emplace_back(i); }
+        }
+
+        unrolled_list(const unrolled_list& other)
+            : allocator_(chunk_traits::select_on_container_copy_construction(other.allocator_))
+        { append_copy(other); }
+
+        unrolled_list(unrolled_list&& other) noexcept
+            : allocator_(other.allocator_)
+        { steal(other); }
+
+        unrolled_list& operator=(const unrolled_list& other)
+        {
+            if (this != &other)
+            {
+                unrolled_list tmp(std::move(*this));
+                if constexpr (chunk_traits::propagate_on_container_copy_assignment::value)
+                    allocator_ = other.allocator_;
+                append_copy(other);
+            }
+            return *this;
+        }
+
+        unrolled_list& operator=(unrolled_list&& other)
+            noexcept(chunk_traits::propagate_on_container_move_assignment::value
+                || chunk_traits::is_always_equal::value)
+        {
+            if (this != &other)
+            {
+                unrolled_list tmp(std::move(*this));
+                if constexpr (chunk_traits::propagate_on_container_move_assignment::value)
+                {
+                    allocator_ = other.allocator_;
+                    steal(other);
+                }
+                else if (chunk_traits::is_always_equal::value || allocator_ == other.allocator_)
+                { steal(other); }
+                else
+                {
+                    for (auto& value : other)
+                    { emplace_back(std::move(value)); }
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        ~unrolled_list() noexcept
+        { clear(); }
+
+        [[nodiscard]] allocator_type get_allocator() const noexcept
+        { return allocator_type(allocator_); }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return size_; }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return size_ == 0; }
+
+        value_type& operator[](const size_t index)
+        {
+            auto [chunk, offset] = locate(index);
+            return chunk->values()[offset];
+        }
+
+        const value_type& operator[](const size_t index) const
+        {
+            auto [chunk, offset] = locate(index);
+            return chunk->values()[offset];
+        }
+
+        value_type& at(const size_t index)
+        { return (*this)[index]; }
+
+        const value_type& at(const size_t index) const
+        { return (*this)[index]; }
+
+        iterator push_back(const value_type& value)
+        { return emplace_back(value); }
+
+        iterator push_back(value_type&& value)
+        { return emplace_back(std::move(value)); }
+
+        iterator push_front(const value_type& value)
+        { return emplace_front(value); }
+
+        iterator push_front(value_type&& value)
+        { return emplace_front(std::move(value)); }
+
+        iterator insert(const size_t index, const value_type& value)
+        { return emplace(index, value); }
+
+        iterator insert(const size_t index, value_type&& value)
+        { return emplace(index, std::move(value)); }
+
+        template<class ...ArgsTy>
+        iterator emplace_back(ArgsTy&& ...args)
+        {
+            if (tail_ == nullptr || tail_->full())
+            {
+                value_type value{std::forward<ArgsTy>(args) ...};
+                link_after(tail_, create_chunk());
+                std::construct_at(tail_->values(), std::move(value));
+            }
+            else
+            { std::construct_at(tail_->values() + tail_->size, std::forward<ArgsTy>(args) ...); }
+
+            tail_->size += 1;
+            size_ += 1;
+            return iterator(tail_, tail_->size - 1);
+        }
+
+        template<class ...ArgsTy>
+        iterator emplace_front(ArgsTy&& ...args)
+        {
+            if (head_ == nullptr || head_->full())
+            {
+                value_type value{std::forward<ArgsTy>(args) ...};
+                link_before(head_, create_chunk());
+                std::construct_at(head_->values(), std::move(value));
+                head_->size += 1;
+                size_ += 1;
+                return begin();
+            }
+            return emplace(begin(), std::forward<ArgsTy>(args) ...);
+        }
+
+        template<class ...ArgsTy>
+        iterator emplace(const size_t index, ArgsTy&& ...args)
+        {
+            if (index == size_)
+                return emplace_back(std::forward<ArgsTy>(args) ...);
+            auto [chunk, offset] = locate(index);
+            return emplace(const_iterator(chunk, offset), std::forward<ArgsTy>(args) ...);
+        }
+
+        template<class ...ArgsTy>
+        iterator emplace(const_iterator position, ArgsTy&& ...args)
+        {
+            if (position == cend())
+                return emplace_back(std::forward<ArgsTy>(args) ...);
+
+            // args may alias an element, so the value is built before shifting
+            value_type value{std::forward<ArgsTy>(args) ...};
+            chunk_type* chunk = const_cast<chunk_type*>(position.chunk_);
+            size_t offset = position.index_;
+
+            if (chunk->full())
+            {
+                chunk_type* right = split(chunk, Capacity / 2);
+                if (offset > chunk->size)
+                {
+                    offset -= chunk->size;
+                    chunk = right;
+                }
+            }
+
+            value_type* values = chunk->values();
+            if (offset == chunk->size)
+                std::construct_at(values + offset, std::move(value));
+            else
+            {
+                std::construct_at(values + chunk->size, std::move(values[chunk->size - 1]));
+                std::move_backward(values + offset, values + chunk->size - 1, values + chunk->size);
+                values[offset] = std::move(value);
+            }
+            chunk->size += 1;
+            size_ += 1;
+            return iterator(chunk, offset);
+        }
+
+        value_type pop_back()
+        {
+            if (size_ == 0)
+            { throw std::runtime_error("list size = 0"); }
+
+            return extract(--end());
+        }
+
+        value_type pop_front()
+        {
+            if (size_ == 0)
+            { throw std::runtime_error("list size = 0"); }
+
+            return extract(begin());
+        }
+
+        iterator erase(const_iterator position)
+        {
+            if (position == cend()) throw std::invalid_argument("index = cend()");
+
+            chunk_type* chunk = const_cast<chunk_type*>(position.chunk_);
+            const size_t offset = position.index_;
+            value_type* values = chunk->values();
+
+            std::move(values + offset + 1, values + chunk->size, values + offset);
+            std::destroy_at(values + chunk->size - 1);
+            chunk->size -= 1;
+            size_ -= 1;
+
+            if (chunk->size == 0)
+            {
+                chunk_type* next = chunk->next;
+                unlink(chunk);
+                destroy_chunk(chunk);
+                return next != nullptr ? iterator(next, 0) : end();
+            }
+
+            merge_with_next(chunk);
+
+            if (offset < chunk->size)
+                return iterator(chunk, offset);
+            return chunk->next != nullptr ? iterator(chunk->next, 0) : end();
+        }
+
+        iterator erase(const_iterator left_it, const_iterator right_it)
+        {
+            size_t count = std::distance(left_it, right_it);
+            iterator it(const_cast<chunk_type*>(left_it.chunk_), left_it.index_);
+            for (; count > 0; --count)
+            { it = erase(it); }
+            return it;
+        }
+
+        iterator erase(size_t index)
+        {
+            auto [chunk, offset] = locate(index);
+            return erase(const_iterator(chunk, offset));
+        }
+
+        // O(1) splice, only the two boundary chunks may be merged
+        void concat(unrolled_list other)
+        {
+            if (!chunk_traits::is_always_equal::value && !(allocator_ == other.allocator_))
+            {
+                for (auto& value : other)
+                { emplace_back(std::move(value)); }
+                return;
+            }
+            if (other.head_ == nullptr)
+                return;
+
+            chunk_type* boundary = tail_;
+            if (tail_ != nullptr)
+            {
+                tail_->next = other.head_;
+                other.head_->previous = tail_;
+            }
+            else
+                head_ = other.head_;
+
+            tail_ = other.tail_;
+            size_ += other.size_;
+            other.head_ = other.tail_ = nullptr;
+            other.size_ = 0;
+
+            if (boundary != nullptr)
+                merge_with_next(boundary);
+        }
+
+        std::pair<unrolled_list, unrolled_list> cut(iterator edge)
+        {
+            if (edge == end())
+                return {std::move(*this), unrolled_list(get_allocator())};
+
+            size_t left_size = edge.index_;
+            for (chunk_type* chunk = head_; chunk != edge.chunk_; chunk = chunk->next)
+            { left_size += chunk->size; }
+
+            return cut(edge.chunk_, edge.index_, left_size);
+        }
+
+        std::pair<unrolled_list, unrolled_list> cut(size_t index)
+        {
+            if (index == size_)
+                return {std::move(*this), unrolled_list(get_allocator())};
+
+            auto [chunk, offset] = locate(index);
+            return cut(chunk, offset, index);
+        }
+
+        [[nodiscard]] size_t chunks_count() const noexcept
+        {
+            size_t count = 0;
+            for (chunk_type* chunk = head_; chunk != nullptr; chunk = chunk->next)
+            { count += 1; }
+            return count;
+        }
+
+        iterator begin() noexcept
+        { return iterator{head_, 0}; }
+        iterator end() noexcept
+        { return iterator{tail_, tail_ != nullptr ? tail_->size : 0}; }
+
+        [[nodiscard]] const_iterator begin() const noexcept
+        { return const_iterator{head_, 0}; }
+        [[nodiscard]] const_iterator end() const noexcept
+        { return const_iterator{tail_, tail_ != nullptr ? tail_->size : 0}; }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept
+        { return begin(); }
+        [[nodiscard]] const_iterator cend() const noexcept
+        { return end(); }
+
+        reverse_iterator rbegin() noexcept
+        { return std::make_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept
+        { return std::make_reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const noexcept
+        { return std::make_reverse_iterator(end()); }
+        [[nodiscard]] const_reverse_iterator rend() const noexcept
+        { return std::make_reverse_iterator(begin()); }
+
+        [[nodiscard]] const_reverse_iterator rcbegin() const noexcept
+        { return std::make_reverse_iterator(cend()); }
+        [[nodiscard]] const_reverse_iterator rcend() const noexcept
+        { return std::make_reverse_iterator(cbegin()); }
+
+        void swap(unrolled_list& other) noexcept
+        {
+            unrolled_list tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        void clear() noexcept
+        {
+            while (head_ != nullptr)
+            {
+                chunk_type* next = head_->next;
+                destroy_chunk(head_);
+                head_ = next;
+            }
+            tail_ = nullptr;
+            size_ = 0;
+        }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        auto operator<=>(const Container& container) const noexcept
+        { return compare_collections(*this, container); }
+
+        template<typename Container>
+        requires std::ranges::range<Container>
+        bool operator==(const Container& container) const noexcept
+        { return is_equal_collections(*this, container); }
+
+    private:
+        chunk_type* create_chunk()
+        {
+            chunk_type* chunk = chunk_traits::allocate(allocator_, 1);
+            std::construct_at(chunk);
+            return chunk;
+        }
+
+        void destroy_chunk(chunk_type* chunk) noexcept
+        {
+            std::destroy_n(chunk->values(), chunk->size);
+            std::destroy_at(chunk);
+            chunk_traits::deallocate(allocator_, chunk, 1);
+        }
+
+        // position == nullptr links chunk as the new tail
+        void link_after(chunk_type* position, chunk_type* chunk) noexcept
+        {
+            if (position == nullptr)
+            {
+                chunk->previous = tail_;
+                if (tail_ != nullptr) tail_->next = chunk;
+                else head_ = chunk;
+                tail_ = chunk;
+                return;
+            }
+            chunk->previous = position;
+            chunk->next = position->next;
+            if (position->next != nullptr) position->next->previous = chunk;
+            else tail_ = chunk;
+            position->next = chunk;
+        }
+
+        // position == nullptr links chunk as the new head
+        void link_before(chunk_type* position, chunk_type* chunk) noexcept
+        {
+            if (position == nullptr || position == head_)
+            {
+                chunk->next = head_;
+                if (head_ != nullptr) head_->previous = chunk;
+                else tail_ = chunk;
+                head_ = chunk;
+                return;
+            }
+            link_after(position->previous, chunk);
+        }
+
+        void unlink(chunk_type* chunk) noexcept
+        {
+            if (chunk->previous != nullptr) chunk->previous->next = chunk->next;
+            else head_ = chunk->next;
+            if (chunk->next != nullptr) chunk->next->previous = chunk->previous;
+            else tail_ = chunk->previous;
+            chunk->next = chunk->previous = nullptr;
+        }
+
+        // moves [offset, size) of chunk into a new chunk linked right after it
+        chunk_type* split(chunk_type* chunk, size_t offset)
+        {
+            chunk_type* right = create_chunk();
+            value_type* values = chunk->values();
+            try
+            {
+                for (size_t i = offset; i < chunk->size; ++i, ++right->size)
+                { std::construct_at(right->values() + right->size, std::move(values[i])); }
+            }
+            catch (...)
+            {
+                destroy_chunk(right);
+                throw;
+            }
+            std::destroy(values + offset, values + chunk->size);
+            chunk->size = offset;
+            link_after(chunk, right);
+            return right;
+        }
+
+        // keeps chunks at least half full where possible
+        void merge_with_next(chunk_type* chunk)
+        {
+            chunk_type* next = chunk->next;
+            if (next == nullptr || chunk->size + next->size > Capacity
+                || (chunk->size >= Capacity / 2 && next->size >= Capacity / 2))
+                return;
+
+            value_type* values = next->values();
+            for (size_t i = 0; i < next->size; ++i, ++chunk->size)
+            { std::construct_at(chunk->values() + chunk->size, std::move(values[i])); }
+            unlink(next);
+            destroy_chunk(next);
+        }
+
+        value_type extract(iterator position)
+        {
+            value_type tmp = std::move(*position);
+            erase(position);
+            return tmp;
+        }
+
+        std::pair<unrolled_list, unrolled_list> cut(chunk_type* chunk, size_t offset, size_t left_size)
+        {
+            if (offset != 0)
+                chunk = split(chunk, offset);
+
+            unrolled_list right(get_allocator());
+            right.head_ = chunk;
+            right.tail_ = tail_;
+            right.size_ = size_ - left_size;
+
+            tail_ = chunk->previous;
+            if (tail_ != nullptr)
+                tail_->next = nullptr;
+            else
+                head_ = nullptr;
+            chunk->previous = nullptr;
+            size_ = left_size;
+
+            unrolled_list left(std::move(*this));
+            return {std::move(left), std::move(right)};
+        }
+
+        [[nodiscard]] std::pair<chunk_type*, size_t> locate(size_t index) const
+        {
+            if (index >= size_)
+            {
+                throw std::out_of_range(
+                    "in unrolled_list index out of range (index) "
+                    + std::to_string(index) + " >= (size) " + std::to_string(size_));
+            }
+            chunk_type* chunk;
+            if (size_ / 2 > index)
+            {
+                chunk = head_;
+                while (index >= chunk->size)
+                {
+                    index -= chunk->size;
+                    chunk = chunk->next;
+                }
+            }
+            else
+            {
+                size_t from_back = size_ - index;
+                chunk = tail_;
+                while (from_back > chunk->size)
+                {
+                    from_back -= chunk->size;
+                    chunk = chunk->previous;
+                }
+                index = chunk->size - from_back;
+            }
+            return {chunk, index};
+        }
+
+        void append_copy(const unrolled_list& other)
+        {
+            for (const auto& value : other)
+            { emplace_back(value); }
+        }
+
+        void steal(unrolled_list& other) noexcept
+        {
+            head_ = std::exchange(other.head_, nullptr);
+            tail_ = std::exchange(other.tail_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        [[no_unique_address]] chunk_allocator_type allocator_{};
+        chunk_type* head_ = nullptr;
+        chunk_type* tail_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    template<typename IteratorType>
+    unrolled_list(IteratorType, IteratorType)
+    -> unrolled_list<typename std::iterator_traits<IteratorType>::value_type>;
+
+    namespace pmr
+    {
+        template<typename T, size_t Capacity = unrolled_list_default_capacity<T>>
+        using unrolled_list = collections::unrolled_list<T, Capacity, std::pmr::polymorphic_allocator<T>>;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "unrolled_list.h"
+
+
+namespace collections
+{
+    namespace sequence_companion
+    {
+        template <typename T, size_t Capacity, typename Allocator>
+        void concat_containers_mut(unrolled_list<T, Capacity, Allocator>& lhs, unrolled_list<T, Capacity, Allocator> rhs)
+        {
+            lhs.concat(std::move(rhs));
+        }
+
+        template<typename T, size_t Capacity, typename Allocator>
+        std::pair<unrolled_list<T, Capacity, Allocator>, unrolled_list<T, Capacity, Allocator>> cut_container_mut
+        (typename unrolled_list<T, Capacity, Allocator>::iterator index, unrolled_list<T, Capacity, Allocator>& cont)
+        {
+            return cont.cut(index);
+        }
+    }
+}
+
+#include "sequence.h"
+
+namespace collections
+{
+
+    template<typename T, size_t Capacity = unrolled_list_default_capacity<T>, typename Allocator = std::allocator<T>>
+    using unrolled_sequence = collections::sequence<unrolled_list<T, Capacity, Allocator>>;
+
+    namespace pmr
+    {
+        template<typename T, size_t Capacity = unrolled_list_default_capacity<T>>
+        using unrolled_sequence = collections::unrolled_sequence<T, Capacity, std::pmr::polymorphic_allocator<T>>;
+    }
+}
@@ -63,6 +63,53 @@ concept is_sizable = requires (Ty t)
     {t.size()} -> std::same_as<size_t>;
 };
 
+template<typename Container>
+concept is_reservable = requires (Container cont, size_t n, typename Container::value_type value)
+{
+    cont.reserve(n);
+    cont.push_back(std::move(value));
+    {cont.capacity()} -> std::same_as<size_t>;
+};
+
+template<typename Container>
+concept is_concatable = requires (Container cont, Container other)
+{
+    cont.concat(std::move(other));
+};
+
+template<typename Container>
+concept is_cuttable = requires (Container cont, typename Container::iterator index)
+{
+    {cont.cut(index)} -> std::same_as<std::pair<Container, Container>>;
+};
+
+template<typename Container>
+concept is_range_insertable = requires (Container cont, typename Container::value_type* values)
+{
+    cont.insert(cont.end(), std::make_move_iterator(values), std::make_move_iterator(values));
+};
+
+template<typename Container>
+concept is_range_erasable = requires (Container cont)
+{
+    cont.erase(cont.begin(), cont.end());
+};
+
+// cut leaves the source untouched and shares structure with it
+template<typename Container>
+concept is_persistent_container = requires (const Container cont, typename Container::const_iterator index)
+{
+    {cont.cut(index)} -> std::same_as<std::pair<Container, Container>>;
+};
+
+// positional lookup that is faster than walking the iterators
+template<typename Container>
+concept has_iterator_at = requires (Container cont, const Container const_cont, size_t index)
+{
+    {cont.iterator_at(index)} -> std::same_as<typename Container::iterator>;
+    {const_cont.iterator_at(index)} -> std::same_as<typename Container::const_iterator>;
+};
+
 template<typename T, typename Container>
 concept is_indexable = requires (Container cont, size_t index)
 {
@@ -1,8 +1,12 @@
 #include "pch.h"
 
+#include <iterator>
 #include <numeric>
+#include <sstream>
 
 #include "dynamic_array.h"
+#include "array_sequence.h"
+#include "counting_allocator.h"
 
 using namespace std;
 using namespace collections;
@@ -217,3 +221,316 @@ TEST(dynamic_array, concepts)
     EXPECT_TRUE(std::ranges::range<dynamic_array<int>>);
 }
 
+
+TEST(dynamic_array, push_back_growth)
+{
+    dynamic_array<int> a;
+    size_t reallocations = 0;
+    size_t last_capacity = a.capacity();
+    for (int i = 0; i < 100000; ++i)
+    {
+        a.push_back(i);
+        if (a.capacity() != last_capacity)
+        {
+            reallocations += 1;
+            last_capacity = a.capacity();
+        }
+    }
+    EXPECT_EQ(a.size(), 100000);
+    EXPECT_GE(a.capacity(), a.size());
+    EXPECT_LT(reallocations, 40);
+    for (int i = 0; i < 100000; ++i)
+    {
+        EXPECT_EQ(a[i], i);
+    }
+}
+
+TEST(dynamic_array, reserve_shrink_to_fit)
+{
+    dynamic_array<int> a{ 0, 1, 2 };
+    a.reserve(100);
+    EXPECT_EQ(a.capacity(), 100);
+    EXPECT_EQ(a, (dynamic_array{ 0, 1, 2 }));
+
+    a.reserve(10);
+    EXPECT_EQ(a.capacity(), 100);
+
+    a.shrink_to_fit();
+    EXPECT_EQ(a.capacity(), 3);
+    EXPECT_EQ(a, (dynamic_array{ 0, 1, 2 }));
+
+    a.clear();
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_EQ(a.capacity(), 3);
+}
+
+TEST(dynamic_array, emplace_pop_back)
+{
+    dynamic_array<pair<int, string>> a;
+    for (int i = 0; i < 10; ++i)
+    {
+        a.emplace_back(i, to_string(i));
+    }
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 9; i >= 0; --i)
+    {
+        EXPECT_EQ(a.pop_back(), pair(i, to_string(i)));
+    }
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a.pop_back());
+
+    dynamic_array<string> b{ "a" };
+    for (int i = 0; i < 10; ++i)
+    {
+        b.push_back(b[0]);
+    }
+    EXPECT_EQ(b.size(), 11);
+    EXPECT_EQ(b[10], "a");
+}
+
+TEST(dynamic_array, custom_growth_policy)
+{
+    dynamic_array<int, std::allocator<int>, geometric_growth<3, 2>> a;
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(i);
+    }
+    EXPECT_EQ(a.size(), 1000);
+    EXPECT_EQ(a[999], 999);
+}
+
+struct construction_counter
+{
+    static inline size_t constructions = 0;
+    static inline size_t copies = 0;
+    static inline size_t moves = 0;
+
+    int value = 0;
+
+    construction_counter() { constructions += 1; }
+    construction_counter(int value) : value(value) { constructions += 1; }
+    construction_counter(const construction_counter& other) : value(other.value) { copies += 1; }
+    construction_counter(construction_counter&& other) noexcept : value(other.value) { moves += 1; }
+    construction_counter& operator=(const construction_counter&) = default;
+    construction_counter& operator=(construction_counter&&) noexcept = default;
+
+    bool operator==(const construction_counter& other) const { return value == other.value; }
+    auto operator<=>(const construction_counter& other) const { return value <=> other.value; }
+
+    static void reset() { constructions = copies = moves = 0; }
+};
+
+TEST(dynamic_array, single_construction)
+{
+    construction_counter::reset();
+    dynamic_array<construction_counter> a(100, construction_counter{ 7 });
+    EXPECT_EQ(construction_counter::constructions, 1);
+    EXPECT_EQ(construction_counter::copies, 100);
+
+    construction_counter::reset();
+    std::vector<construction_counter> source(50);
+    construction_counter::reset();
+    dynamic_array<construction_counter> b(source.begin(), source.end());
+    EXPECT_EQ(construction_counter::constructions, 0);
+    EXPECT_EQ(construction_counter::copies, 50);
+
+    construction_counter::reset();
+    dynamic_array<construction_counter> c;
+    c.reserve(10);
+    EXPECT_EQ(construction_counter::constructions, 0);
+}
+
+TEST(dynamic_array, relocation_moves)
+{
+    dynamic_array<construction_counter> a;
+    construction_counter::reset();
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.emplace_back(i);
+    }
+    EXPECT_EQ(construction_counter::constructions, 1000);
+    EXPECT_EQ(construction_counter::copies, 0);
+    EXPECT_LT(construction_counter::moves, 2000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(a[i].value, i);
+    }
+
+    dynamic_array<string> s;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.push_back(string(100, 'a' + i % 26));
+    }
+    s.shrink_to_fit();
+    EXPECT_EQ(s[999], string(100, 'a' + 999 % 26));
+}
+
+// copying throws once copies_left runs out, the move may throw too so relocation copies
+struct throwing_copy
+{
+    static inline size_t live = 0;
+    static inline int copies_left = -1;
+
+    int value = 0;
+
+    throwing_copy(int value) : value(value) { live += 1; }
+    throwing_copy(const throwing_copy& other) : value(other.value)
+    {
+        if (copies_left >= 0 && copies_left-- == 0)
+            throw runtime_error("copy");
+        live += 1;
+    }
+    throwing_copy(throwing_copy&& other) : value(other.value) { live += 1; }
+    throwing_copy& operator=(const throwing_copy&) = default;
+    throwing_copy& operator=(throwing_copy&&) = default;
+    ~throwing_copy() { live -= 1; }
+};
+
+TEST(dynamic_array, throwing_relocation)
+{
+    {
+        dynamic_array<throwing_copy> a;
+        for (int i = 0; i < 4; ++i)
+        {
+            a.emplace_back(i);
+        }
+        a.shrink_to_fit();
+
+        throwing_copy::copies_left = 2;
+        EXPECT_THROW(a.emplace_back(4), runtime_error);
+        throwing_copy::copies_left = -1;
+        EXPECT_EQ(throwing_copy::live, 4);
+        EXPECT_EQ(a.size(), 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(a[i].value, i);
+        }
+
+        // the prefix is relocated, then the suffix copy throws
+        vector<throwing_copy> middle{ 10, 11 };
+        throwing_copy::copies_left = 5;
+        EXPECT_THROW(a.insert(a.cbegin() + 2, middle.begin(), middle.end()), runtime_error);
+        throwing_copy::copies_left = -1;
+        EXPECT_EQ(throwing_copy::live, 6);
+        EXPECT_EQ(a.size(), 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(a[i].value, i);
+        }
+    }
+    EXPECT_EQ(throwing_copy::live, 0);
+}
+
+TEST(dynamic_array, memory_resource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    collections::pmr::dynamic_array<string> a(&arena);
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(to_string(i));
+    }
+    EXPECT_EQ(a.get_allocator().resource(), &arena);
+    EXPECT_EQ(a[999], "999");
+
+    collections::pmr::dynamic_array<string> b(a);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(b.get_allocator().resource(), std::pmr::get_default_resource());
+
+    std::pmr::unsynchronized_pool_resource pool;
+    collections::pmr::dynamic_array<string> c(&pool);
+    c = std::move(a);
+    EXPECT_EQ(c.get_allocator().resource(), &pool);
+    EXPECT_EQ(c, b);
+
+    collections::pmr::dynamic_array<string> d(std::move(c));
+    EXPECT_EQ(d.get_allocator().resource(), &pool);
+    EXPECT_EQ(d, b);
+}
+
+TEST(dynamic_array, insert_erase)
+{
+    dynamic_array<string> a{ "0", "1", "5", "6" };
+    vector<string> middle{ "2", "3", "4" };
+    a.reserve(10);
+    auto it = a.insert(a.cbegin() + 2, middle.begin(), middle.end());
+    EXPECT_EQ(*it, "2");
+    EXPECT_EQ(a, (vector<string>{ "0", "1", "2", "3", "4", "5", "6" }));
+
+    a.shrink_to_fit();
+    it = a.insert(a.cend(), middle.begin(), middle.end());
+    EXPECT_EQ(it - a.begin(), 7);
+    EXPECT_EQ(a.size(), 10);
+    EXPECT_EQ(a[9], "4");
+
+    it = a.erase(a.cbegin() + 1, a.cbegin() + 8);
+    EXPECT_EQ(*it, "3");
+    EXPECT_EQ(a, (vector<string>{ "0", "3", "4" }));
+    a.erase(a.cbegin(), a.cend());
+    EXPECT_TRUE(a.empty());
+
+    // an empty range in the middle leaves the tail as it was
+    vector<string> long_strings;
+    for (int i = 0; i < 8; ++i)
+    {
+        long_strings.push_back(string(40, 'a' + i));
+    }
+    dynamic_array<string> b(long_strings.begin(), long_strings.end());
+    it = b.erase(b.cbegin() + 6, b.cbegin() + 6);
+    EXPECT_EQ(it - b.begin(), 6);
+    EXPECT_EQ(b, long_strings);
+
+    // a single pass range is read once
+    istringstream input("7 8 9");
+    dynamic_array<int> c{ 1, 2 };
+    c.insert(c.cbegin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+    EXPECT_EQ(c, (vector<int>{ 1, 7, 8, 9, 2 }));
+}
+
+TEST(dynamic_array, companion_allocations)
+{
+    using counted = dynamic_array<int, testing::counting_allocator<int>>;
+    using counted_sequence = array_sequence<int, testing::counting_allocator<int>>;
+    using testing::allocation_counter;
+
+    counted storage(1000, 1);
+    storage.reserve(3000);
+    counted_sequence seq(std::move(storage));
+    counted_sequence back(counted(1000, 2)), middle(counted(1000, 2)), front(counted(1000, 2));
+
+    allocation_counter::reset();
+    seq.append_back_mut(std::move(back));
+    seq.insert_mut(500, std::move(middle));
+    EXPECT_EQ(allocation_counter::allocations, 0);
+    EXPECT_EQ(seq.size(), 3000);
+    EXPECT_EQ(seq[499], 1);
+    EXPECT_EQ(seq[500], 2);
+    EXPECT_EQ(seq[1500], 1);
+
+    allocation_counter::reset();
+    seq.append_front_mut(std::move(front));
+    EXPECT_EQ(allocation_counter::allocations, 1);
+    EXPECT_EQ(seq[0], 2);
+    EXPECT_EQ(seq.size(), 4000);
+
+    allocation_counter::reset();
+    auto [left, right] = seq.cut_mut(1000);
+    EXPECT_EQ(allocation_counter::allocations, 1);
+    EXPECT_EQ(left.size(), 1000);
+    EXPECT_EQ(right.size(), 3000);
+
+    allocation_counter::reset();
+    auto extracted = right.extract_subsequence(1000, 2000);
+    EXPECT_EQ(allocation_counter::allocations, 1);
+    EXPECT_EQ(extracted.size(), 1000);
+    EXPECT_EQ(extracted[0], 2);
+    EXPECT_EQ(extracted[999], 1);
+    EXPECT_EQ(right.size(), 2000);
+    EXPECT_EQ(right[499], 1);
+    EXPECT_EQ(right[500], 2);
+
+    allocation_counter::reset();
+    auto released = right.release_container();
+    EXPECT_EQ(allocation_counter::allocations, 0);
+    EXPECT_EQ(released.size(), 2000);
+    EXPECT_EQ(right.size(), 0);
+}
@@ -0,0 +1,219 @@
+#include "pch.h"
+
+#include <indexed_list.h>
+#include <indexed_sequence.h>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <algorithm>
+
+using namespace std;
+using namespace collections;
+
+TEST(indexed_list, default_constructror) 
+{
+    indexed_list<int> a;
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a[0]);
+    EXPECT_EQ(a.begin(), a.end());
+    EXPECT_EQ(a.cbegin(), a.cend());
+}
+
+TEST(indexed_list, initialization_list) 
+{
+    indexed_list<int> a{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i);
+    }
+    EXPECT_ANY_THROW(a[10]);
+
+    indexed_list<pair<int, int>> b{ {0, 0}, {1, 0}, {2, 0}, {3, 0} };
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(b[i], pair(i, 0));
+    }
+}
+
+TEST(indexed_list, copying_moving) 
+{
+    indexed_list<string> a{ "0", "1", "2", "3", "4", "5" };
+    indexed_list<string> b(a);
+    indexed_list<string> c = b;
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(c, a);
+
+    indexed_list<string> d(std::move(c));
+    EXPECT_EQ(d, a);
+    EXPECT_EQ(c.size(), 0);
+    EXPECT_EQ(c.begin(), c.end());
+
+    c = std::move(d);
+    EXPECT_EQ(c, a);
+    EXPECT_EQ(d.size(), 0);
+}
+
+TEST(indexed_list, iterators)
+{
+    indexed_list<int> a{ 0, 1, 2, 3, 4, 5, 6 };
+    int ii = 0;
+    for (auto i = a.begin(); i != a.end(); ++i)
+    {
+        EXPECT_EQ(*i, ii);
+        ++ii;
+    }
+    EXPECT_EQ(ii, 7);
+    for (auto i = a.rbegin(); i != a.rend(); ++i)
+    {
+        --ii;
+        EXPECT_EQ(*i, ii);
+    }
+    EXPECT_EQ(ii, 0);
+    EXPECT_TRUE(is_sorted(a.begin(), a.end()));
+}
+
+TEST(indexed_list, random_modifications)
+{
+    indexed_list<int> a;
+    std::list<int> correct;
+    std::mt19937 gen(42);
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        const int action = gen() % 6;
+        const int value = static_cast<int>(gen() % 1000);
+        const size_t index = correct.empty() ? 0 : gen() % (correct.size() + 1);
+        if (action == 0)
+        {
+            a.push_back(value);
+            correct.push_back(value);
+        }
+        else if (action == 1)
+        {
+            a.push_front(value);
+            correct.push_front(value);
+        }
+        else if (action == 2 || action == 3)
+        {
+            a.insert(index, value);
+            correct.insert(next(correct.begin(), index), value);
+        }
+        else if (!correct.empty() && index < correct.size())
+        {
+            EXPECT_EQ(a[index], *next(correct.begin(), index));
+            a.erase(index);
+            correct.erase(next(correct.begin(), index));
+        }
+        ASSERT_EQ(a.size(), correct.size());
+    }
+    EXPECT_EQ(a, correct);
+
+    auto it = correct.begin();
+    for (size_t i = 0; i < correct.size(); ++i, ++it)
+    {
+        ASSERT_EQ(a[i], *it);
+    }
+
+    while (!correct.empty())
+    {
+        EXPECT_EQ(a.pop_back(), correct.back());
+        correct.pop_back();
+        if (correct.empty())
+            break;
+        EXPECT_EQ(a.pop_front(), correct.front());
+        correct.pop_front();
+    }
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a.pop_back());
+}
+
+TEST(indexed_list, concat_cut)
+{
+    vector<int> data(100);
+    iota(data.begin(), data.end(), 0);
+
+    for (size_t edge = 0; edge <= data.size(); ++edge)
+    {
+        indexed_list<int> a(data.begin(), data.end());
+        auto [left, right] = a.cut(edge);
+        EXPECT_EQ(left.size(), edge);
+        EXPECT_EQ(right.size(), data.size() - edge);
+        for (size_t i = 0; i < right.size(); ++i)
+        {
+            EXPECT_EQ(right[i], data[edge + i]);
+        }
+
+        left.concat(std::move(right));
+        EXPECT_EQ(left, data);
+        EXPECT_EQ(right.size(), 0);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            EXPECT_EQ(left[i], data[i]);
+        }
+        EXPECT_EQ(*left.rbegin(), data.back());
+    }
+}
+
+TEST(indexed_list, erase_by_iterator)
+{
+    indexed_list<int> a{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    auto it = a.erase(next(a.cbegin(), 2));
+    EXPECT_EQ(*it, 3);
+    it = a.erase(next(a.cbegin(), 4), next(a.cbegin(), 7));
+    EXPECT_EQ(*it, 8);
+    EXPECT_EQ(a, (vector{ 0, 1, 3, 4, 8, 9 }));
+    a.emplace(next(a.cbegin(), 2), 2);
+    EXPECT_EQ(a, (vector{ 0, 1, 2, 3, 4, 8, 9 }));
+}
+
+TEST(indexed_list, sequence)
+{
+    indexed_sequence<int> a = indexed_list<int>{ 0, 1, 2, 3, 4, 5 };
+    a.append_back_mut(indexed_list<int>{ 6, 7 });
+    a.append_front_mut(indexed_list<int>{ -2, -1 });
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i - 2);
+    }
+
+    auto [left, right] = a.cut(3);
+    EXPECT_EQ(left.size(), 3);
+    EXPECT_EQ(right[0], 1);
+
+    auto middle = a.extract_subsequence(2, 5);
+    EXPECT_EQ(middle.size(), 3);
+    EXPECT_EQ(middle[0], 0);
+    EXPECT_EQ(a.size(), 7);
+    EXPECT_EQ(a[2], 3);
+}
+
+TEST(indexed_list, iterator_at)
+{
+    indexed_list<int> a;
+    for (int i = 0; i < 1000; ++i)
+    { a.push_back(i); }
+
+    for (size_t i = 0; i < 1000; i += 37)
+    {
+        EXPECT_EQ(*a.iterator_at(i), static_cast<int>(i));
+    }
+    EXPECT_TRUE(a.iterator_at(1000) == a.end());
+    EXPECT_THROW(a.iterator_at(1001), std::out_of_range);
+
+    indexed_sequence<int> s = std::move(a);
+    auto middle = s.extract_subsequence(100, 200);
+    EXPECT_EQ(middle.size(), 100);
+    EXPECT_EQ(middle[0], 100);
+    EXPECT_EQ(s[100], 200);
+}
+
+TEST(indexed_list, concepts)
+{
+    EXPECT_TRUE(std::ranges::range<indexed_list<int>>);
+    EXPECT_TRUE(std::bidirectional_iterator<indexed_list<int>::iterator>);
+    EXPECT_TRUE(is_container<indexed_list<int>>);
+    EXPECT_TRUE(has_iterator_at<indexed_list<int>>);
+}
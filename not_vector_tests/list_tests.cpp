@@ -331,3 +331,172 @@ TEST(linked_list, concepts)
     EXPECT_TRUE(std::ranges::range<linked_list<int>>);
 }
 
+
+TEST(linked_list, memory_resource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    collections::pmr::linked_list<string> a(&arena);
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(to_string(i));
+    }
+    EXPECT_EQ(a.get_allocator().resource(), &arena);
+    EXPECT_EQ(a[999], "999");
+
+    collections::pmr::linked_list<string> b(a);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(b.get_allocator().resource(), std::pmr::get_default_resource());
+
+    std::pmr::unsynchronized_pool_resource pool;
+    collections::pmr::linked_list<string> c(&pool);
+    c = std::move(a);
+    EXPECT_EQ(c.get_allocator().resource(), &pool);
+    EXPECT_EQ(c, b);
+
+    c.concat(b);
+    EXPECT_EQ(c.size(), 2000);
+    EXPECT_EQ(c[1999], "999");
+
+    auto [left, right] = c.cut(1000);
+    EXPECT_EQ(left, b);
+    EXPECT_EQ(right, b);
+    EXPECT_EQ(right.get_allocator().resource(), &pool);
+}
+
+TEST(linked_list, node_pool)
+{
+    pooled_linked_list<string> a;
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(to_string(i));
+    }
+    const auto pool = a.get_allocator().pool();
+    const size_t chunks = pool->chunks_count();
+    EXPECT_GE(pool->block_size(), sizeof(string) + 2 * sizeof(void*));
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            a.pop_front();
+        }
+        for (int i = 0; i < 500; ++i)
+        {
+            a.push_back(to_string(i));
+        }
+    }
+    EXPECT_EQ(a.size(), 1000);
+    EXPECT_EQ(pool->chunks_count(), chunks);
+
+    pooled_linked_list<string> b(a);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a.get_allocator(), b.get_allocator());
+}
+
+TEST(linked_list, shared_node_pool)
+{
+    pool_allocator<int> shared;
+    pooled_linked_list<int> a({ 0, 1, 2 }, shared);
+    pooled_linked_list<int> b({ 3, 4, 5 }, shared);
+
+    auto* first_of_b = &b[0];
+    a.concat(std::move(b));
+    EXPECT_EQ(a, (linked_list{ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_EQ(&a[3], first_of_b);
+
+    auto [left, right] = a.cut(2);
+    EXPECT_EQ(left, (linked_list{ 0, 1 }));
+    EXPECT_EQ(right, (linked_list{ 2, 3, 4, 5 }));
+    EXPECT_EQ(right.get_allocator(), shared);
+}
+
+TEST(linked_list, sort)
+{
+    linked_list<int> empty;
+    empty.sort();
+    EXPECT_EQ(empty.size(), 0);
+
+    vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i)
+        values[i] = (i * 7919) % 1000 / 3;
+
+    linked_list<int> a(values.begin(), values.end());
+    vector<const int*> addresses;
+    for (const auto& value : a)
+        addresses.push_back(&value);
+
+    a.sort();
+    EXPECT_TRUE(ranges::is_sorted(a));
+    EXPECT_EQ(a.size(), 1000);
+    EXPECT_EQ(*a.rbegin(), 333);
+    // nodes are relinked, values stay where they were
+    ranges::sort(addresses, [](const int* l, const int* r) { return *l < *r; });
+    EXPECT_TRUE(ranges::all_of(a, [&](const int& value)
+        { return ranges::binary_search(addresses, &value, [](const int* l, const int* r) { return *l < *r; }); }));
+
+    a.sort(greater<int>{});
+    EXPECT_TRUE(ranges::is_sorted(a, greater<int>{}));
+
+    linked_list<pair<int, int>> stable;
+    for (int i = 0; i < 100; ++i)
+        stable.push_back({ (100 - i) % 5, i });
+    stable.sort([](const auto& l, const auto& r) { return l.first < r.first; });
+    EXPECT_TRUE(ranges::is_sorted(stable));
+}
+
+TEST(linked_list, merge)
+{
+    linked_list<int> a{ 1, 3, 5, 7 };
+    linked_list<int> b{ 0, 2, 3, 8, 9 };
+    auto* three_of_b = &b[2];
+
+    a.merge(b);
+    EXPECT_EQ(a, (linked_list{ 0, 1, 2, 3, 3, 5, 7, 8, 9 }));
+    EXPECT_EQ(&a[4], three_of_b);
+    EXPECT_EQ(b.size(), 0);
+    EXPECT_EQ(*a.rbegin(), 9);
+
+    a.merge(linked_list<int>{ 4, 10 });
+    EXPECT_EQ(a, (linked_list{ 0, 1, 2, 3, 3, 4, 5, 7, 8, 9, 10 }));
+
+    pooled_linked_list<string> c({ "a", "c" });
+    pooled_linked_list<string> d({ "b", "d" });
+    c.merge(d);
+    EXPECT_EQ(c, (linked_list<string>{ "a", "b", "c", "d" }));
+}
+
+TEST(linked_list, throwing_comparator)
+{
+    vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i)
+        values[i] = (i * 7919) % 1000;
+
+    for (int calls : { 0, 1, 10, 500, 1500, 5000 })
+    {
+        int left = calls;
+        auto cmp = [&left](int l, int r)
+        {
+            if (left-- == 0)
+                throw runtime_error("cmp");
+            return l < r;
+        };
+
+        // the list keeps all of its values, linked both ways
+        linked_list<int> a(values.begin(), values.end());
+        EXPECT_THROW(a.sort(cmp), runtime_error);
+        EXPECT_EQ(a.size(), 1000);
+        vector<int> forward(a.begin(), a.end()), backward(a.rbegin(), a.rend());
+        EXPECT_TRUE(ranges::equal(forward, backward | views::reverse));
+        ranges::sort(forward);
+        EXPECT_TRUE(ranges::equal(forward, views::iota(0, 1000)));
+
+        left = calls % 11;
+        linked_list<int> b{ 1, 3, 5, 7, 9, 11 }, c{ 0, 2, 4, 6, 8, 10 };
+        EXPECT_THROW(b.merge(c, cmp), runtime_error);
+        EXPECT_EQ(b.size(), 12);
+        EXPECT_EQ(c.size(), 0);
+        vector<int> merged(b.rbegin(), b.rend());
+        ranges::sort(merged);
+        EXPECT_TRUE(ranges::equal(merged, views::iota(0, 12)));
+    }
+}
@@ -0,0 +1,281 @@
+#include "pch.h"
+
+#include <rope.h>
+#include <rope_sequence.h>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <algorithm>
+
+using namespace std;
+using namespace collections;
+
+TEST(rope, default_constructror) 
+{
+    rope<int> a;
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a[0]);
+    EXPECT_EQ(a.begin(), a.end());
+    EXPECT_EQ(a.cbegin(), a.cend());
+}
+
+TEST(rope, initialization_list) 
+{
+    rope<int, 4> a{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i);
+    }
+    EXPECT_ANY_THROW(a[10]);
+
+    rope<pair<int, int>, 4> b{ {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0} };
+    for (int i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(b[i], pair(i, 0));
+    }
+}
+
+TEST(rope, iterators)
+{
+    vector<int> data(1000);
+    iota(data.begin(), data.end(), 0);
+    rope<int, 8> a(data.begin(), data.end());
+    EXPECT_EQ(a, data);
+    EXPECT_TRUE(equal(a.rbegin(), a.rend(), data.rbegin(), data.rend()));
+    EXPECT_EQ(a.end() - a.begin(), 1000);
+    EXPECT_EQ(*(a.begin() + 517), 517);
+    EXPECT_EQ(a.begin()[998], 998);
+    EXPECT_EQ(*lower_bound(a.begin(), a.end(), 345), 345);
+}
+
+TEST(rope, persistence)
+{
+    rope<string, 4> a{ "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+    rope<string, 4> b = a;
+    b[3] = "three";
+    b.push_back("10");
+    b.erase(0);
+    EXPECT_EQ(a[3], "3");
+    EXPECT_EQ(a.size(), 10);
+    EXPECT_EQ(b[2], "three");
+    EXPECT_EQ(b.size(), 10);
+
+    auto [left, right] = a.cut(5);
+    EXPECT_EQ(a.size(), 10);
+    EXPECT_EQ(left, (vector<string>{ "0", "1", "2", "3", "4" }));
+    EXPECT_EQ(right, (vector<string>{ "5", "6", "7", "8", "9" }));
+
+    rope<string, 4> c(std::move(b));
+    EXPECT_EQ(c.size(), 10);
+    EXPECT_EQ(b.size(), 0);
+}
+
+TEST(rope, random_modifications)
+{
+    rope<int, 8> a;
+    std::list<int> correct;
+    std::mt19937 gen(42);
+    vector<rope<int, 8>> snapshots;
+    vector<vector<int>> expected;
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        const int action = gen() % 7;
+        const int value = static_cast<int>(gen() % 1000);
+        const size_t index = correct.empty() ? 0 : gen() % (correct.size() + 1);
+        if (action == 0)
+        {
+            a.push_back(value);
+            correct.push_back(value);
+        }
+        else if (action == 1)
+        {
+            a.push_front(value);
+            correct.push_front(value);
+        }
+        else if (action == 2 || action == 3)
+        {
+            a.insert(index, value);
+            correct.insert(next(correct.begin(), index), value);
+        }
+        else if (action == 4 && index < correct.size())
+        {
+            a[index] = value;
+            *next(correct.begin(), index) = value;
+        }
+        else if (!correct.empty() && index < correct.size())
+        {
+            a.erase(index);
+            correct.erase(next(correct.begin(), index));
+        }
+        ASSERT_EQ(a.size(), correct.size());
+        if (step % 500 == 0)
+        {
+            snapshots.push_back(a);
+            expected.emplace_back(correct.begin(), correct.end());
+        }
+    }
+    EXPECT_EQ(a, correct);
+    EXPECT_LE(a.height(), 2 * std::bit_width(a.size()) + 2);
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        EXPECT_EQ(snapshots[i], expected[i]);
+    }
+
+    while (!correct.empty())
+    {
+        EXPECT_EQ(a.pop_back(), correct.back());
+        correct.pop_back();
+        if (correct.empty())
+            break;
+        EXPECT_EQ(a.pop_front(), correct.front());
+        correct.pop_front();
+    }
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a.pop_back());
+}
+
+TEST(rope, concat_cut)
+{
+    vector<int> data(200);
+    iota(data.begin(), data.end(), 0);
+    const rope<int, 8> a(data.begin(), data.end());
+
+    for (size_t edge = 0; edge <= data.size(); ++edge)
+    {
+        auto [left, right] = a.cut(edge);
+        EXPECT_EQ(left.size(), edge);
+        EXPECT_EQ(right.size(), data.size() - edge);
+        EXPECT_TRUE(equal(left.begin(), left.end(), data.begin(), data.begin() + edge));
+        EXPECT_TRUE(equal(right.begin(), right.end(), data.begin() + edge, data.end()));
+
+        right.concat(left);
+        left.concat(a.cut(edge).second);
+        EXPECT_EQ(left, data);
+        EXPECT_TRUE(equal(right.begin(), right.begin() + (data.size() - edge), data.begin() + edge));
+    }
+    EXPECT_EQ(a.subrope(10, 20), (vector{ 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }));
+}
+
+TEST(rope, repeated_extraction)
+{
+    std::mt19937 gen(7);
+    vector<int> correct(5000);
+    iota(correct.begin(), correct.end(), 0);
+    rope<int, 16> a(correct.begin(), correct.end());
+
+    for (int step = 0; step < 300; ++step)
+    {
+        const size_t left = gen() % correct.size();
+        const size_t right = left + gen() % (correct.size() - left + 1);
+        const size_t where = gen() % (correct.size() - (right - left) + 1);
+
+        auto middle = a.subrope(left, right);
+        a.erase(left, right);
+        auto [head, tail] = a.cut(where);
+        head.concat(middle);
+        head.concat(tail);
+        a = head;
+
+        vector<int> moved(correct.begin() + left, correct.begin() + right);
+        correct.erase(correct.begin() + left, correct.begin() + right);
+        correct.insert(correct.begin() + where, moved.begin(), moved.end());
+    }
+    EXPECT_EQ(a, correct);
+    EXPECT_LE(a.height(), 2 * std::bit_width(a.size()) + 2);
+}
+
+TEST(rope, sequence)
+{
+    rope_sequence<int, 4> a = rope<int, 4>{ 0, 1, 2, 3, 4, 5 };
+    a.append_back_mut(rope<int, 4>{ 6, 7 });
+    a.append_front_mut(rope<int, 4>{ -2, -1 });
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i - 2);
+    }
+
+    auto [left, right] = a.cut(3);
+    EXPECT_EQ(left.size(), 3);
+    EXPECT_EQ(right[0], 1);
+
+    auto middle = a.extract_subsequence(2, 5);
+    EXPECT_EQ(middle.size(), 3);
+    EXPECT_EQ(middle[0], 0);
+    EXPECT_EQ(a.size(), 7);
+    EXPECT_EQ(a[2], 3);
+}
+
+TEST(rope, concepts)
+{
+    EXPECT_TRUE(std::ranges::range<rope<int>>);
+    EXPECT_TRUE(std::random_access_iterator<rope<int>::iterator>);
+    EXPECT_TRUE(is_container<rope<int>>);
+}
+
+TEST(rope, memory_resource)
+{
+    std::pmr::monotonic_buffer_resource resource;
+    collections::pmr::rope<int, 4> a({ 0, 1, 2, 3, 4, 5, 6, 7 }, &resource);
+    a.insert(3, 42);
+    auto [left, right] = a.cut(4);
+    EXPECT_EQ(left.get_allocator().resource(), &resource);
+    EXPECT_EQ(right, (vector{ 3, 4, 5, 6, 7 }));
+}
+
+namespace
+{
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t n, size_t alignment) override
+        {
+            bytes += n;
+            return std::pmr::new_delete_resource()->allocate(n, alignment);
+        }
+
+        void do_deallocate(void* p, size_t n, size_t alignment) override
+        { std::pmr::new_delete_resource()->deallocate(p, n, alignment); }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        { return this == &other; }
+    };
+}
+
+TEST(rope, persistent_sequence)
+{
+    counting_resource counter;
+    auto* previous = std::pmr::set_default_resource(&counter);
+    {
+        const size_t n = 100000;
+        vector<int> data(n);
+        iota(data.begin(), data.end(), 0);
+        const collections::pmr::rope_sequence<int> a = collections::pmr::rope<int>(data.begin(), data.end());
+        const collections::pmr::rope_sequence<int> tail = collections::pmr::rope<int>{ -1, -2 };
+
+        counter.bytes = 0;
+        auto b = a.append_back(tail);
+        auto c = a.insert(n / 2, tail);
+        auto [l, r] = a.cut(n / 3);
+        auto d = a.get_subsequence(10, n - 10);
+        EXPECT_LT(counter.bytes, n * sizeof(int) / 10);
+
+        EXPECT_EQ(a.size(), n);
+        EXPECT_EQ(b.size(), n + 2);
+        EXPECT_EQ(b[n + 1], -2);
+        EXPECT_EQ(c[n / 2], -1);
+        EXPECT_EQ(c[n / 2 + 2], static_cast<int>(n / 2));
+        EXPECT_EQ(l.size(), n / 3);
+        EXPECT_EQ(r[0], static_cast<int>(n / 3));
+        EXPECT_EQ(d.size(), n - 20);
+        EXPECT_EQ(d[0], 10);
+        EXPECT_TRUE(is_equal_collections(a, data));
+    }
+    std::pmr::set_default_resource(previous);
+}
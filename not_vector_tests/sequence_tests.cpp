@@ -262,3 +262,68 @@ TEST(sequence, insert_seq)
     });
 }
 
+
+TEST(sequence, views)
+{
+    type_combined_test([]<typename T, typename Container>(T ty, Container co) {
+        size_t n = 10;
+        Container ll(n);
+        generate(begin(ll), end(ll), random_generator<T>());
+        const sequence<Container> seq(ll);
+
+        auto all = seq.view();
+        EXPECT_EQ(all.size(), n);
+        EXPECT_TRUE(is_equal_collections(all, seq));
+
+        auto middle = seq.subsequence_view(2, 8);
+        EXPECT_EQ(middle.size(), 6);
+        EXPECT_EQ(&middle[0], &seq[2]);
+        EXPECT_EQ(&middle[5], &seq[7]);
+        EXPECT_ANY_THROW(middle.at(6));
+        EXPECT_ANY_THROW(seq.subsequence_view(3, 11));
+
+        auto nested = middle.subview(1, 3);
+        EXPECT_EQ(nested.size(), 2);
+        EXPECT_EQ(&nested[0], &seq[3]);
+        EXPECT_EQ(&*nested.begin(), &seq[3]);
+
+        auto [l, r] = middle.cut(4);
+        EXPECT_EQ(l.size(), 4);
+        EXPECT_EQ(&r[0], &seq[6]);
+
+        auto owned = nested.materialize();
+        EXPECT_EQ(owned.size(), 2);
+        EXPECT_EQ(owned[0], seq[3]);
+        EXPECT_EQ(owned[1], seq[4]);
+        EXPECT_EQ(seq.size(), n);
+
+        EXPECT_TRUE(std::ranges::view<decltype(middle)>);
+        EXPECT_TRUE(std::ranges::borrowed_range<decltype(middle)>);
+    });
+}
+
+TEST(sequence, insert_const)
+{
+    type_combined_test([]<typename T, typename Container>(T ty, Container co) {
+        size_t n = 5;
+        size_t m = 3;
+        Container container1(n);
+        generate(begin(container1), end(container1), random_generator<T>());
+        Container container2(m);
+        generate(begin(container2), end(container2), random_generator<T>());
+
+        const sequence<Container> seq(container1);
+        const sequence<Container> seq2(container2);
+        auto inserted = seq.insert(2, seq2);
+
+        EXPECT_EQ(inserted.size(), n + m);
+        EXPECT_EQ(seq.size(), n);
+        EXPECT_EQ(inserted[0], seq[0]);
+        EXPECT_EQ(inserted[1], seq[1]);
+        for (size_t i = 0; i < m; ++i)
+        {
+            EXPECT_EQ(inserted[i + 2], seq2[i]);
+        }
+        EXPECT_EQ(inserted[n + m - 1], seq[n - 1]);
+    });
+}
@@ -0,0 +1,173 @@
+#include "pch.h"
+
+#include <unrolled_list.h>
+#include <unrolled_sequence.h>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <algorithm>
+
+using namespace std;
+using namespace collections;
+
+TEST(unrolled_list, default_constructror) 
+{
+    unrolled_list<int> a;
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_ANY_THROW(a[0]);
+    EXPECT_EQ(a.begin(), a.end());
+    EXPECT_EQ(a.cbegin(), a.cend());
+}
+
+TEST(unrolled_list, initialization_list) 
+{
+    unrolled_list<int, 4> a{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i);
+    }
+
+    unrolled_list<pair<int, int>, 4> b{ {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0} };
+    for (int i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(b[i], pair(i, 0));
+    }
+}
+
+TEST(unrolled_list, copying_moving) 
+{
+    unrolled_list<string, 4> a{ "0", "1", "2", "3", "4", "5" };
+    unrolled_list<string, 4> b(a);
+    unrolled_list<string, 4> c = b;
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(c, a);
+
+    unrolled_list<string, 4> d(std::move(c));
+    EXPECT_EQ(d, a);
+    EXPECT_EQ(c.size(), 0);
+    EXPECT_EQ(c.begin(), c.end());
+
+    c = std::move(d);
+    EXPECT_EQ(c, a);
+    EXPECT_EQ(d.size(), 0);
+}
+
+TEST(unrolled_list, iterators)
+{
+    unrolled_list<int, 3> a{ 0, 1, 2, 3, 4, 5, 6 };
+    int ii = 0;
+    for (auto i = a.begin(); i != a.end(); ++i)
+    {
+        EXPECT_EQ(*i, ii);
+        ++ii;
+    }
+    EXPECT_EQ(ii, 7);
+    for (auto i = a.rbegin(); i != a.rend(); ++i)
+    {
+        --ii;
+        EXPECT_EQ(*i, ii);
+    }
+    EXPECT_EQ(ii, 0);
+    EXPECT_TRUE(is_sorted(a.begin(), a.end()));
+}
+
+TEST(unrolled_list, random_modifications)
+{
+    unrolled_list<int, 8> a;
+    std::list<int> correct;
+    std::mt19937 gen(42);
+
+    for (int step = 0; step < 5000; ++step)
+    {
+        const int action = gen() % 6;
+        const int value = static_cast<int>(gen() % 1000);
+        const size_t index = correct.empty() ? 0 : gen() % (correct.size() + 1);
+        if (action == 0)
+        {
+            a.push_back(value);
+            correct.push_back(value);
+        }
+        else if (action == 1)
+        {
+            a.push_front(value);
+            correct.push_front(value);
+        }
+        else if (action == 2 || action == 3)
+        {
+            a.insert(index, value);
+            correct.insert(next(correct.begin(), index), value);
+        }
+        else if (!correct.empty() && index < correct.size())
+        {
+            a.erase(index);
+            correct.erase(next(correct.begin(), index));
+        }
+        ASSERT_EQ(a.size(), correct.size());
+    }
+    EXPECT_EQ(a, correct);
+    EXPECT_LE(a.chunks_count(), 2 * a.size() / 8 + 2);
+
+    while (!correct.empty())
+    {
+        EXPECT_EQ(a.pop_back(), correct.back());
+        correct.pop_back();
+        if (correct.empty())
+            break;
+        EXPECT_EQ(a.pop_front(), correct.front());
+        correct.pop_front();
+    }
+    EXPECT_EQ(a.size(), 0);
+    EXPECT_EQ(a.chunks_count(), 0);
+    EXPECT_ANY_THROW(a.pop_back());
+}
+
+TEST(unrolled_list, concat_cut)
+{
+    vector<int> data(100);
+    iota(data.begin(), data.end(), 0);
+
+    for (size_t edge = 0; edge <= data.size(); ++edge)
+    {
+        unrolled_list<int, 8> a(data.begin(), data.end());
+        auto [left, right] = a.cut(edge);
+        EXPECT_EQ(left.size(), edge);
+        EXPECT_EQ(right.size(), data.size() - edge);
+        EXPECT_TRUE(is_equal_collections(left.begin(), left.end(), data.begin(), data.begin() + edge));
+        EXPECT_TRUE(is_equal_collections(right.begin(), right.end(), data.begin() + edge, data.end()));
+
+        left.concat(std::move(right));
+        EXPECT_EQ(left, data);
+        EXPECT_EQ(right.size(), 0);
+    }
+}
+
+TEST(unrolled_list, sequence)
+{
+    unrolled_sequence<int, 4> a = unrolled_list<int, 4>{ 0, 1, 2, 3, 4, 5 };
+    a.append_back_mut(unrolled_list<int, 4>{ 6, 7 });
+    a.append_front_mut(unrolled_list<int, 4>{ -2, -1 });
+    EXPECT_EQ(a.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(a[i], i - 2);
+    }
+
+    auto [left, right] = a.cut(3);
+    EXPECT_EQ(left.size(), 3);
+    EXPECT_EQ(right[0], 1);
+
+    auto middle = a.extract_subsequence(2, 5);
+    EXPECT_EQ(middle.size(), 3);
+    EXPECT_EQ(middle[0], 0);
+    EXPECT_EQ(a.size(), 7);
+    EXPECT_EQ(a[2], 3);
+}
+
+TEST(unrolled_list, concepts)
+{
+    EXPECT_TRUE(std::ranges::range<unrolled_list<int>>);
+    EXPECT_TRUE(std::bidirectional_iterator<unrolled_list<int>::iterator>);
+    EXPECT_TRUE(is_container<unrolled_list<int>>);
+}